@@ -85,6 +85,8 @@ void ProjectConfigPage::updateCommandLine()
     m_parameters->useProjectIncludes = ui->kcfg_useProjectIncludes->isChecked();
     m_parameters->useSystemIncludes = ui->kcfg_useSystemIncludes->isChecked();
     m_parameters->ignoredIncludes = ui->kcfg_ignoredIncludes->text();
+    m_parameters->parallelAnalysis = ui->kcfg_parallelAnalysis->isChecked();
+    m_parameters->incrementalAnalysis = ui->kcfg_incrementalAnalysis->isChecked();
     m_parameters->extraParameters = ui->kcfg_extraParameters->text().trimmed();
 
     QString message;
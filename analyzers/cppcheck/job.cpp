@@ -29,15 +29,21 @@
 
 #include "debug.h"
 #include "parser.h"
+#include "resultcache.h"
 #include "utils.h"
 
 #include <klocalizedstring.h>
 #include <kmessagebox.h>
 #include <shell/problem.h>
+#include <util/processlinemaker.h>
 
 #include <QApplication>
 #include <QElapsedTimer>
+#include <QFutureWatcher>
 #include <QRegularExpression>
+#include <QThread>
+#include <QTimer>
+#include <QtConcurrentRun>
 
 namespace cppcheck
 {
@@ -45,9 +51,16 @@ namespace cppcheck
 Job::Job(const Parameters& params, QObject* parent)
     : KDevelop::OutputExecuteJob(parent)
     , m_timer(new QElapsedTimer)
-    , m_parser(new CppcheckParser)
     , m_showXmlOutput(params.showXmlOutput)
     , m_projectRootPath(params.projectRootPath())
+    , m_parameters(params)
+    , m_hashingInputs(false)
+    , m_cache(new ResultCache(params.projectRootPath()))
+    , m_checkCount(0)
+    , m_finishedChecks(0)
+    , m_processExited(false)
+    , m_exitCode(0)
+    , m_exitStatus(QProcess::NormalExit)
 {
     setJobName(i18n("Cppcheck Analysis (%1)", prettyPathName(params.checkPath)));
 
@@ -59,7 +72,7 @@ Job::Job(const Parameters& params, QObject* parent)
     setProperties(KDevelop::OutputExecuteJob::JobProperty::DisplayStderr);
     setProperties(KDevelop::OutputExecuteJob::JobProperty::PostProcessOutput);
 
-    *this << params.commandLine();
+    m_check.parser.reset(new CppcheckParser);
     qCDebug(KDEV_CPPCHECK) << "checking path" << params.checkPath;
 }
 
@@ -82,8 +95,9 @@ void Job::postProcessStdout(const QStringList& lines)
             continue;
         }
 
+        // the progress of parallel checks is counted by finished processes
         match = percentRegex.match(line);
-        if (match.hasMatch()) {
+        if (match.hasMatch() && m_checkCount == 1) {
             setPercent(match.captured(1).toULong());
             continue;
         }
@@ -97,9 +111,16 @@ void Job::postProcessStdout(const QStringList& lines)
 }
 
 void Job::postProcessStderr(const QStringList& lines)
+{
+    processStderr(lines, m_check);
+}
+
+void Job::processStderr(const QStringList& lines, RunningCheck& check)
 {
     static const auto xmlStartRegex = QRegularExpression("\\s*<");
 
+    check.errorOutput << lines;
+
     for (const QString & line : lines) {
         // unfortunately sometime cppcheck send non-XML messages to stderr.
         // For example, if we pass '-I /missing_include_dir' to the argument list,
@@ -112,9 +133,9 @@ void Job::postProcessStderr(const QStringList& lines)
         if (line.indexOf(xmlStartRegex) != -1) { // the line contains XML
             m_xmlOutput << line;
 
-            m_parser->addData(line);
+            check.parser->addData(line);
 
-            m_problems = m_parser->parse();
+            m_problems = check.parser->parse();
             emitProblems();
         }
         else {
@@ -140,15 +161,99 @@ void Job::postProcessStderr(const QStringList& lines)
     }
 }
 
+static QList<Check> hashInputs(QList<Check> checks, const KDevelop::Path& projectRootPath)
+{
+    ResultCache cache(projectRootPath);
+    cache.prune();
+
+    const QByteArray toolVersion = ResultCache::toolVersion(checks.first().commandLine.first());
+    for (auto& check : checks) {
+        check.inputHash = cache.inputHash(check.file, toolVersion, check.commandLine, check.includeDirectories);
+    }
+
+    return checks;
+}
+
 void Job::start()
 {
     m_standardOutput.clear();
     m_xmlOutput.clear();
 
+    m_timer->restart();
+
+    // the project model is only used in this thread
+    m_pendingChecks = m_parameters.checks();
+    m_checkCount = m_pendingChecks.size();
+
+    if (m_pendingChecks.first().file.isEmpty()) {
+        startChecks();
+        return;
+    }
+
+    // reading all sources and their headers takes a while
+    m_hashingInputs = true;
+
+    auto watcher = new QFutureWatcher<QList<Check>>(this);
+    connect(watcher, &QFutureWatcher<QList<Check>>::finished, this, [this, watcher]() {
+        m_hashingInputs = false;
+        m_pendingChecks = watcher->result();
+        watcher->deleteLater();
+
+        // unless killed meanwhile
+        if (!error()) {
+            startChecks();
+        }
+    });
+    watcher->setFuture(QtConcurrent::run(hashInputs, m_pendingChecks, m_projectRootPath));
+}
+
+void Job::startChecks()
+{
+    loadCachedResults();
+
+    if (m_pendingChecks.isEmpty()) {
+        qCDebug(KDEV_CPPCHECK) << "all results are cached";
+
+        m_processExited = true;
+        QTimer::singleShot(0, this, [this]() {
+            // unless killed meanwhile
+            if (!error()) {
+                emitResult();
+            }
+        });
+        return;
+    }
+
+    m_check.check = m_pendingChecks.takeFirst();
+    *this << m_check.check.commandLine;
+
     qCDebug(KDEV_CPPCHECK) << "executing:" << commandLine().join(' ');
 
-    m_timer->restart();
     KDevelop::OutputExecuteJob::start();
+
+    startParallelProcesses();
+}
+
+void Job::loadCachedResults()
+{
+    for (auto it = m_pendingChecks.begin(); it != m_pendingChecks.end();) {
+        QStringList output;
+        if (it->inputHash.isEmpty() || !m_cache->load(it->file, it->inputHash, output)) {
+            ++it;
+            continue;
+        }
+
+        RunningCheck cached{*it, QSharedPointer<CppcheckParser>(new CppcheckParser), QStringList()};
+        processStderr(output, cached);
+
+        ++m_finishedChecks;
+        it = m_pendingChecks.erase(it);
+    }
+
+    if (m_finishedChecks) {
+        qCDebug(KDEV_CPPCHECK) << "using cached results for" << m_finishedChecks << "of" << m_checkCount << "files";
+        setPercent(m_finishedChecks * 100 / m_checkCount);
+    }
 }
 
 void Job::childProcessError(QProcess::ProcessError e)
@@ -189,22 +294,131 @@ void Job::childProcessError(QProcess::ProcessError e)
     }
 
     KDevelop::OutputExecuteJob::childProcessError(e);
+
+    if (status() != KDevelop::OutputExecuteJob::JobStatus::JobRunning) {
+        killParallelProcesses();
+    }
 }
 
 void Job::childProcessExited(int exitCode, QProcess::ExitStatus exitStatus)
 {
     qCDebug(KDEV_CPPCHECK) << "Process Finished, exitCode" << exitCode << "process exit status" << exitStatus;
 
+    m_processExited = true;
+    checkFinished(m_check, exitCode, exitStatus);
+}
+
+void Job::startParallelProcesses()
+{
+    // the job's own process counts as long as it runs
+    const int maxProcesses = QThread::idealThreadCount() - (m_processExited ? 0 : 1);
+
+    while (!m_pendingChecks.isEmpty() && m_parallelProcesses.size() < maxProcesses) {
+        const Check check = m_pendingChecks.takeFirst();
+        const QStringList& commandLine = check.commandLine;
+
+        auto process = new QProcess(this);
+        auto lineMaker = new KDevelop::ProcessLineMaker(process, process);
+        m_parallelProcesses.insert(process, {check, QSharedPointer<CppcheckParser>(new CppcheckParser), QStringList()});
+
+        connect(lineMaker, &KDevelop::ProcessLineMaker::receivedStdoutLines,
+                this, &Job::postProcessStdout);
+        connect(lineMaker, &KDevelop::ProcessLineMaker::receivedStderrLines,
+                this, [this, process](const QStringList& lines) {
+            processStderr(lines, m_parallelProcesses[process]);
+        });
+        connect(process, static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+                this, [this, process, lineMaker](int exitCode, QProcess::ExitStatus exitStatus) {
+            lineMaker->flushBuffers();
+
+            const RunningCheck check = m_parallelProcesses.take(process);
+            process->deleteLater();
+            checkFinished(check, exitCode, exitStatus);
+        });
+#if QT_VERSION < 0x050600
+        connect(process, static_cast<void(QProcess::*)(QProcess::ProcessError)>(&QProcess::error),
+#else
+        connect(process, &QProcess::errorOccurred,
+#endif
+                this, [this](QProcess::ProcessError error) {
+            // the other errors are followed by finished()
+            if (error == QProcess::FailedToStart) {
+                childProcessError(error);
+            }
+        });
+
+        qCDebug(KDEV_CPPCHECK) << "executing:" << commandLine.join(' ');
+        process->start(commandLine.first(), commandLine.mid(1));
+    }
+}
+
+void Job::checkFinished(const RunningCheck& check, int exitCode, QProcess::ExitStatus exitStatus)
+{
+    if (exitCode == 0 && exitStatus == QProcess::NormalExit && !check.check.inputHash.isEmpty()) {
+        m_cache->store(check.check.file, check.check.inputHash, check.errorOutput);
+    }
+
+    if (m_exitCode == 0) {
+        m_exitCode = exitCode;
+    }
+    if (exitStatus == QProcess::CrashExit) {
+        m_exitStatus = exitStatus;
+    }
+
+    ++m_finishedChecks;
+    if (m_checkCount > 1) {
+        setPercent(m_finishedChecks * 100 / m_checkCount);
+    }
+
+    startParallelProcesses();
+
+    if (m_processExited && m_parallelProcesses.isEmpty()) {
+        processesFinished();
+    }
+}
+
+void Job::killParallelProcesses()
+{
+    m_pendingChecks.clear();
+
+    for (auto process : m_parallelProcesses.keys()) {
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished();
+        process->deleteLater();
+    }
+    m_parallelProcesses.clear();
+}
+
+void Job::processesFinished()
+{
     postProcessStdout({QString("Elapsed time: %1 s.").arg(m_timer->elapsed()/1000.0)});
 
-    if (exitCode != 0) {
+    if (m_exitCode != 0) {
         qCDebug(KDEV_CPPCHECK) << "cppcheck failed, standard output: ";
         qCDebug(KDEV_CPPCHECK) << m_standardOutput.join('\n');
         qCDebug(KDEV_CPPCHECK) << "cppcheck failed, XML output: ";
         qCDebug(KDEV_CPPCHECK) << m_xmlOutput.join('\n');
     }
 
-    KDevelop::OutputExecuteJob::childProcessExited(exitCode, exitStatus);
+    KDevelop::OutputExecuteJob::childProcessExited(m_exitCode, m_exitStatus);
+}
+
+bool Job::doKill()
+{
+    killParallelProcesses();
+
+    if (m_hashingInputs) {
+        // no process was started yet
+        return true;
+    }
+
+    if (m_processExited) {
+        // only the other processes were still running
+        return true;
+    }
+
+    return KDevelop::OutputExecuteJob::doKill();
 }
 
 void Job::emitProblems()
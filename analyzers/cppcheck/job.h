@@ -31,12 +31,16 @@
 #include <interfaces/iproblem.h>
 #include <outputview/outputexecutejob.h>
 
+#include <QHash>
+#include <QSharedPointer>
+
 class QElapsedTimer;
 
 namespace cppcheck
 {
 
 class CppcheckParser;
+class ResultCache;
 
 class Job : public KDevelop::OutputExecuteJob
 {
@@ -59,11 +63,24 @@ protected slots:
     void childProcessError(QProcess::ProcessError processError) override;
 
 protected:
+    /// A check with the parser of its output, since every process writes its own XML document
+    struct RunningCheck
+    {
+        Check check;
+        QSharedPointer<CppcheckParser> parser;
+        /// everything written to stderr, which is what the result cache stores
+        QStringList errorOutput;
+    };
+
+    bool doKill() override;
+
+    void processStderr(const QStringList& lines, RunningCheck& check);
     void emitProblems();
 
     QScopedPointer<QElapsedTimer> m_timer;
 
-    QScopedPointer<CppcheckParser> m_parser;
+    /// the check run by the job's own process
+    RunningCheck m_check;
     QVector<KDevelop::IProblem::Ptr> m_problems;
 
     QStringList m_standardOutput;
@@ -72,6 +89,33 @@ protected:
     bool m_showXmlOutput;
 
     KDevelop::Path m_projectRootPath;
+
+private:
+    void startChecks();
+    void loadCachedResults();
+    void startParallelProcesses();
+    void checkFinished(const RunningCheck& check, int exitCode, QProcess::ExitStatus exitStatus);
+    void killParallelProcesses();
+    void processesFinished();
+
+    Parameters m_parameters;
+
+    /// The checks which still have to be started, the first one is run by the
+    /// job's own process, see Parameters::checks()
+    QList<Check> m_pendingChecks;
+    /// whether the input hashes of the checks are being computed in the background
+    bool m_hashingInputs;
+    /// the checks run by other processes at the same time
+    QHash<QProcess*, RunningCheck> m_parallelProcesses;
+
+    QScopedPointer<ResultCache> m_cache;
+
+    int m_checkCount;
+    int m_finishedChecks;
+
+    bool m_processExited;
+    int m_exitCode;
+    QProcess::ExitStatus m_exitStatus;
 };
 
 }
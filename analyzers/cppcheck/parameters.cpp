@@ -20,6 +20,7 @@
 
 #include "parameters.h"
 
+#include "debug.h"
 #include "globalsettings.h"
 #include "projectsettings.h"
 
@@ -31,7 +32,9 @@
 #include <KLocalizedString>
 
 #include <QFile>
+#include <QFileInfo>
 #include <QRegularExpression>
+#include <QThread>
 
 namespace cppcheck
 {
@@ -58,6 +61,39 @@ void includesForItem(KDevelop::ProjectBaseItem* parent, QSet<KDevelop::Path>& in
     }
 }
 
+bool isSourceFile(const KDevelop::Path& path)
+{
+    static const QStringList suffixes = {
+        QStringLiteral("c"), QStringLiteral("cc"), QStringLiteral("cpp"), QStringLiteral("cxx"),
+        QStringLiteral("c++"), QStringLiteral("tpp"), QStringLiteral("txx")
+    };
+
+    return suffixes.contains(QFileInfo(path.lastPathSegment()).suffix(), Qt::CaseInsensitive);
+}
+
+void sourcesForItem(KDevelop::ProjectBaseItem* parent, const KDevelop::Path& checkPath,
+                    QHash<KDevelop::Path, KDevelop::ProjectFileItem*>& sources)
+{
+    foreach (auto child, parent->children()) {
+        if (auto file = child->file()) {
+            const auto& path = file->path();
+            if ((path != checkPath && !checkPath.isParentOf(path)) || !isSourceFile(path)) {
+                continue;
+            }
+
+            // A file might be listed in different targets, prefer the one of a target
+            // since only those have the right includes and defines.
+            auto& source = sources[path];
+            if (!source || !dynamic_cast<KDevelop::ProjectTargetItem*>(source->parent())) {
+                source = file;
+            }
+            continue;
+        }
+
+        sourcesForItem(child, checkPath, sources);
+    }
+}
+
 QList<KDevelop::Path> includesForProject(KDevelop::IProject* project)
 {
     QSet<KDevelop::Path> includesSet;
@@ -87,6 +123,9 @@ Parameters::Parameters(KDevelop::IProject* project)
         useProjectIncludes   = defaults::useProjectIncludes;
         useSystemIncludes    = defaults::useSystemIncludes;
 
+        parallelAnalysis     = defaults::parallelAnalysis;
+        incrementalAnalysis  = defaults::incrementalAnalysis;
+
         return;
     }
 
@@ -108,6 +147,9 @@ Parameters::Parameters(KDevelop::IProject* project)
     useSystemIncludes    = projectSettings.useSystemIncludes();
     ignoredIncludes      = projectSettings.ignoredIncludes();
 
+    parallelAnalysis     = projectSettings.parallelAnalysis();
+    incrementalAnalysis  = projectSettings.incrementalAnalysis();
+
     extraParameters      = projectSettings.extraParameters();
 
     m_projectRootPath    = m_project->path();
@@ -125,6 +167,15 @@ QStringList Parameters::commandLine() const
 }
 
 QStringList Parameters::commandLine(QString& infoMessage) const
+{
+    QStringList result = commonArguments(infoMessage);
+    result << includeArguments(usedIncludeDirectories(m_includeDirectories));
+    result << checkPath;
+
+    return result;
+}
+
+QStringList Parameters::commonArguments(QString& infoMessage) const
 {
     static const auto mocHeaderRegex = QRegularExpression("#define\\s+Q_MOC_OUTPUT_REVISION\\s+(.+)");
     static const auto mocParametersRegex = QRegularExpression("-DQ_MOC_OUTPUT_REVISION=\\d{2,}");
@@ -213,6 +264,13 @@ QStringList Parameters::commandLine(QString& infoMessage) const
         result << KShell::splitArgs(applyPlaceholders(extraParameters));
     }
 
+    return result;
+}
+
+QList<KDevelop::Path> Parameters::usedIncludeDirectories(const QList<KDevelop::Path>& includeDirectories) const
+{
+    QList<KDevelop::Path> result;
+
     if (m_project && useProjectIncludes) {
         QList<KDevelop::Path> ignored;
 
@@ -222,7 +280,7 @@ QStringList Parameters::commandLine(QString& infoMessage) const
             }
         }
 
-        foreach (const auto& dir, m_includeDirectories) {
+        foreach (const auto& dir, includeDirectories) {
             if (ignored.contains(dir)) {
                 continue;
             }
@@ -231,13 +289,115 @@ QStringList Parameters::commandLine(QString& infoMessage) const
                      dir == m_projectRootPath || m_projectRootPath.isParentOf(dir) ||
                      dir == m_projectBuildPath || m_projectBuildPath.isParentOf(dir)) {
 
-                result << QStringLiteral("-I");
-                result << dir.toLocalFile();
+                result << dir;
             }
         }
     }
 
-    result << checkPath;
+    return result;
+}
+
+QStringList Parameters::includeArguments(const QList<KDevelop::Path>& includeDirectories) const
+{
+    QStringList result;
+
+    foreach (const auto& dir, includeDirectories) {
+        result << QStringLiteral("-I");
+        result << dir.toLocalFile();
+    }
+
+    return result;
+}
+
+QList<Check> Parameters::checks() const
+{
+    const QList<Check> singleCheck = {Check{commandLine(), QString(), QByteArray()}};
+
+    // unusedFunction needs to see the whole program at once
+    if (!m_project || !(parallelAnalysis || incrementalAnalysis) || checkUnusedFunction) {
+        return singleCheck;
+    }
+
+    auto buildSystemManager = m_project->buildSystemManager();
+    if (!buildSystemManager) {
+        return singleCheck;
+    }
+
+    QHash<KDevelop::Path, KDevelop::ProjectFileItem*> files;
+    sourcesForItem(m_project->projectItem(), KDevelop::Path(checkPath), files);
+    if (files.isEmpty()) {
+        return singleCheck;
+    }
+
+    // Group the files by their flags. Passing the defines also makes cppcheck check
+    // only the configuration which is really built instead of all possible ones.
+    struct Group
+    {
+        QStringList flags;
+        QList<KDevelop::Path> includeDirectories;
+        QStringList files;
+    };
+    QHash<QString, Group> groups;
+
+    const auto projectIncludeDirectories = usedIncludeDirectories(m_includeDirectories);
+    for (auto it = files.constBegin(); it != files.constEnd(); ++it) {
+        if (!parallelAnalysis) {
+            // the same flags as for a single process
+            auto& group = groups[QString()];
+            group.includeDirectories = projectIncludeDirectories;
+            group.flags = includeArguments(projectIncludeDirectories);
+            group.files << it.key().toLocalFile();
+            continue;
+        }
+
+        const auto includeDirectories = usedIncludeDirectories(buildSystemManager->includeDirectories(it.value()));
+        QStringList flags = includeArguments(includeDirectories);
+
+        QStringList defineFlags;
+        const auto defines = buildSystemManager->defines(it.value());
+        for (auto define = defines.constBegin(); define != defines.constEnd(); ++define) {
+            if (define.value().isEmpty()) {
+                defineFlags << QStringLiteral("-D%1").arg(define.key());
+            } else {
+                defineFlags << QStringLiteral("-D%1=%2").arg(define.key(), define.value());
+            }
+        }
+        defineFlags.sort();
+        flags << defineFlags;
+
+        auto& group = groups[flags.join(QLatin1Char('\n'))];
+        group.flags = flags;
+        group.includeDirectories = includeDirectories;
+        group.files << it.key().toLocalFile();
+    }
+
+    // several processes per core, so that groups of very different sizes still
+    // keep all cores busy until the end
+    const int maxFilesPerProcess = incrementalAnalysis ? 1 :
+        qBound(1, files.size() / (QThread::idealThreadCount() * 4), 100);
+
+    QString infoMessage;
+    const QStringList arguments = commonArguments(infoMessage);
+
+    QList<Check> result;
+    for (auto group = groups.begin(); group != groups.end(); ++group) {
+        const QStringList groupArguments = arguments + group->flags;
+        QStringList& sources = group->files;
+        sources.sort();
+
+        for (int i = 0; i < sources.size(); i += maxFilesPerProcess) {
+            Check check;
+            check.commandLine = groupArguments + sources.mid(i, maxFilesPerProcess);
+            if (incrementalAnalysis) {
+                check.file = sources.at(i);
+                check.includeDirectories = group->includeDirectories;
+            }
+            result << check;
+        }
+    }
+
+    qCDebug(KDEV_CPPCHECK) << "checking" << files.size() << "files in" << groups.size()
+                           << "groups with" << result.size() << "processes";
 
     return result;
 }
@@ -23,6 +23,8 @@
 
 #include <util/path.h>
 
+#include <QStringList>
+
 namespace KDevelop
 {
 class IProject;
@@ -53,8 +55,23 @@ static const bool checkConfig = false;
 static const bool useProjectIncludes = true;
 static const bool useSystemIncludes = false;
 
+static const bool parallelAnalysis = false;
+static const bool incrementalAnalysis = false;
+
 }
 
+/// The arguments of one cppcheck process
+struct Check
+{
+    QStringList commandLine;
+
+    /// In incremental mode the only file checked, the directories its headers are looked
+    /// up in and the hash of all inputs of its check, see ResultCache. Empty otherwise.
+    QString file;
+    QList<KDevelop::Path> includeDirectories;
+    QByteArray inputHash;
+};
+
 class Parameters
 {
 public:
@@ -63,6 +80,19 @@ public:
     QStringList commandLine() const;
     QStringList commandLine(QString& infoMessage) const;
 
+    /**
+     * The cppcheck processes checking the files under checkPath.
+     *
+     * In parallel mode the source files are grouped by the include directories and
+     * defines the build system manager reports for them, every group being split into
+     * several processes to keep all cores busy. In incremental mode every source file
+     * is checked by its own process, so that its results can be cached. The input hashes
+     * are left empty, they are computed by the job since that reads all files.
+     *
+     * @return only commandLine() if neither mode is enabled or applicable
+     */
+    QList<Check> checks() const;
+
     // global settings
     QString executablePath;
     bool hideOutputView;
@@ -83,6 +113,9 @@ public:
     bool useSystemIncludes;
     QString ignoredIncludes;
 
+    bool parallelAnalysis;
+    bool incrementalAnalysis;
+
     QString extraParameters;
 
     // runtime settings
@@ -91,6 +124,10 @@ public:
     KDevelop::Path projectRootPath() const;
 
 private:
+    QStringList commonArguments(QString& infoMessage) const;
+    QList<KDevelop::Path> usedIncludeDirectories(const QList<KDevelop::Path>& includeDirectories) const;
+    QStringList includeArguments(const QList<KDevelop::Path>& includeDirectories) const;
+
     QString applyPlaceholders(const QString& text) const;
 
     KDevelop::IProject* m_project;
@@ -195,8 +195,10 @@ void Plugin::result(KJob*)
     } else {
         m_model->setProblems();
 
+        // the job does not start a process if all results are cached
         if (m_job->status() == KDevelop::OutputExecuteJob::JobStatus::JobSucceeded ||
-            m_job->status() == KDevelop::OutputExecuteJob::JobStatus::JobCanceled) {
+            m_job->status() == KDevelop::OutputExecuteJob::JobStatus::JobCanceled ||
+            (m_job->status() == KDevelop::OutputExecuteJob::JobStatus::JobNotStarted && !m_job->error())) {
             raiseProblemsView();
         } else {
             raiseOutputView();
@@ -0,0 +1,211 @@
+/* This file is part of KDevelop
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "resultcache.h"
+
+#include "debug.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+
+namespace cppcheck
+{
+
+static QByteArray sha1(const QByteArray& data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+}
+
+ResultCache::ResultCache(const KDevelop::Path& projectRootPath)
+    : m_directory(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) +
+                  QStringLiteral("/kdevcppcheck/") +
+                  QString::fromLatin1(sha1(projectRootPath.toLocalFile().toUtf8())))
+{
+}
+
+const ResultCache::FileInfo& ResultCache::fileInfo(const QString& file)
+{
+    static const auto includeRegex = QRegularExpression(
+        QStringLiteral("^\\s*#\\s*include\\s*([<\"])([^>\"]+)[>\"]"),
+        QRegularExpression::MultilineOption);
+
+    auto it = m_fileInfos.find(file);
+    if (it != m_fileInfos.end()) {
+        return *it;
+    }
+
+    FileInfo info;
+
+    QFile f(file);
+    if (f.open(QIODevice::ReadOnly)) {
+        const QByteArray contents = f.readAll();
+        info.hash = sha1(contents);
+
+        auto matches = includeRegex.globalMatch(QString::fromLocal8Bit(contents));
+        while (matches.hasNext()) {
+            const auto match = matches.next();
+            if (match.captured(1) == QLatin1String("\"")) {
+                info.includes << QLatin1Char('"') + match.captured(2);
+            } else {
+                info.includes << match.captured(2);
+            }
+        }
+    }
+
+    return *m_fileInfos.insert(file, info);
+}
+
+QByteArray ResultCache::toolVersion(const QString& executable)
+{
+    QProcess process;
+    process.start(executable, {QStringLiteral("--version")});
+    if (process.waitForFinished() && process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0) {
+        return process.readAllStandardOutput().trimmed();
+    }
+
+    qCDebug(KDEV_CPPCHECK) << "failed to query the version of" << executable;
+
+    QFileInfo info(executable);
+    if (!info.exists()) {
+        info.setFile(QStandardPaths::findExecutable(executable));
+    }
+    return info.lastModified().toString(Qt::ISODate).toUtf8();
+}
+
+QByteArray ResultCache::inputHash(const QString& file, const QByteArray& toolVersion, const QStringList& arguments,
+                                  const QList<KDevelop::Path>& includeDirectories)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(toolVersion);
+    hash.addData(arguments.join(QLatin1Char('\n')).toUtf8());
+
+    // the file and all headers it includes, directly or not
+    QStringList pending = {file};
+    QSet<QString> visited = {file};
+
+    while (!pending.isEmpty()) {
+        const QString current = pending.takeFirst();
+        const FileInfo& info = fileInfo(current);
+        hash.addData(current.toUtf8());
+        hash.addData(info.hash);
+
+        const QDir currentDirectory = QFileInfo(current).absoluteDir();
+        foreach (const QString& include, info.includes) {
+            const bool quoted = include.startsWith(QLatin1Char('"'));
+            const QString name = quoted ? include.mid(1) : include;
+
+            QString header;
+            if (quoted && QFileInfo::exists(currentDirectory.filePath(name))) {
+                header = currentDirectory.filePath(name);
+            } else {
+                foreach (const auto& dir, includeDirectories) {
+                    const QString candidate = QDir(dir.toLocalFile()).filePath(name);
+                    if (QFileInfo::exists(candidate)) {
+                        header = candidate;
+                        break;
+                    }
+                }
+            }
+            header = QDir::cleanPath(header);
+
+            // a header which is not found now might appear later
+            hash.addData(header.toUtf8());
+
+            if (!header.isEmpty() && !visited.contains(header)) {
+                visited.insert(header);
+                pending << header;
+            }
+        }
+    }
+
+    return hash.result().toHex();
+}
+
+QString ResultCache::entryFileName(const QString& file) const
+{
+    return m_directory + QLatin1Char('/') + QString::fromLatin1(sha1(file.toUtf8()));
+}
+
+bool ResultCache::load(const QString& file, const QByteArray& inputHash, QStringList& output) const
+{
+    QFile entry(entryFileName(file));
+    if (!entry.open(QIODevice::ReadOnly) || entry.readLine().trimmed() != inputHash) {
+        return false;
+    }
+    // the checked file, see prune()
+    entry.readLine();
+
+    output.clear();
+    foreach (const QByteArray& line, entry.readAll().split('\n')) {
+        if (!line.isEmpty()) {
+            output << QString::fromUtf8(line);
+        }
+    }
+
+    return true;
+}
+
+void ResultCache::store(const QString& file, const QByteArray& inputHash, const QStringList& output) const
+{
+    QDir().mkpath(m_directory);
+
+    QSaveFile entry(entryFileName(file));
+    if (!entry.open(QIODevice::WriteOnly)) {
+        qCDebug(KDEV_CPPCHECK) << "failed to write result cache entry for" << file;
+        return;
+    }
+
+    entry.write(inputHash + '\n');
+    entry.write(file.toUtf8() + '\n');
+    entry.write(output.join(QLatin1Char('\n')).toUtf8());
+    entry.commit();
+}
+
+void ResultCache::prune() const
+{
+    const auto entries = QDir(m_directory).entryInfoList(QDir::Files);
+    for (const QFileInfo& info : entries) {
+        // skip the temporary files of store()
+        if (info.fileName().contains(QLatin1Char('.'))) {
+            continue;
+        }
+
+        QFile entry(info.filePath());
+        if (!entry.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        entry.readLine();
+        const QString file = QString::fromUtf8(entry.readLine().trimmed());
+        entry.close();
+
+        if (!QFileInfo::exists(file)) {
+            qCDebug(KDEV_CPPCHECK) << "removing the result cache entry of" << file;
+            entry.remove();
+        }
+    }
+}
+
+}
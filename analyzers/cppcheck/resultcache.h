@@ -0,0 +1,83 @@
+/* This file is part of KDevelop
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#pragma once
+
+#include <util/path.h>
+
+#include <QHash>
+#include <QStringList>
+
+namespace cppcheck
+{
+
+/**
+ * The cppcheck output for single source files of a project, used by the
+ * incremental mode to check only the files whose inputs changed.
+ *
+ * An entry is only valid for the input hash it was stored with, which covers
+ * everything the output depends on: the cppcheck version, the arguments, the
+ * file and the headers it includes.
+ */
+class ResultCache
+{
+public:
+    explicit ResultCache(const KDevelop::Path& projectRootPath);
+
+    /**
+     * @return the version of the cppcheck @p executable, or its modification
+     * time if it can not be queried
+     *
+     * This starts the executable and waits for it, call it once per job.
+     */
+    static QByteArray toolVersion(const QString& executable);
+
+    /**
+     * @return the hash of the inputs of checking @p file with @p arguments by the
+     * cppcheck of @p toolVersion, the included headers are looked up like cppcheck
+     * does in @p includeDirectories
+     */
+    QByteArray inputHash(const QString& file, const QByteArray& toolVersion, const QStringList& arguments,
+                         const QList<KDevelop::Path>& includeDirectories);
+
+    /// @return whether there is output for @p file with @p inputHash, which is stored in @p output
+    bool load(const QString& file, const QByteArray& inputHash, QStringList& output) const;
+
+    void store(const QString& file, const QByteArray& inputHash, const QStringList& output) const;
+
+    /// Removes the entries of files which do not exist anymore
+    void prune() const;
+
+private:
+    struct FileInfo
+    {
+        QByteArray hash;
+        /// the included files, quoted ones prefixed by '"'
+        QStringList includes;
+    };
+
+    const FileInfo& fileInfo(const QString& file);
+    QString entryFileName(const QString& file) const;
+
+    QString m_directory;
+
+    /// the files read for inputHash() so far, headers are included by many files
+    QHash<QString, FileInfo> m_fileInfos;
+};
+
+}
@@ -0,0 +1,118 @@
+/* This file is part of KDevelop
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public
+   License as published by the Free Software Foundation; either
+   version 2 of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+*/
+
+#include "test_cppcheckresultcache.h"
+
+#include <QtTest/QTest>
+#include <QFile>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+
+#include "resultcache.h"
+
+using namespace KDevelop;
+using namespace cppcheck;
+
+static void writeFile(const QString& fileName, const QByteArray& contents)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(contents);
+}
+
+void TestCppcheckResultCache::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void TestCppcheckResultCache::testInputHash()
+{
+    QTemporaryDir project;
+    QTemporaryDir includes;
+    const QString source = project.path() + QStringLiteral("/source.cpp");
+    const QString localHeader = project.path() + QStringLiteral("/local.h");
+    const QString header = includes.path() + QStringLiteral("/header.h");
+
+    writeFile(source, "#include \"local.h\"\nint main() {}\n");
+    writeFile(localHeader, "#include <header.h>\n");
+    writeFile(header, "int foo();\n");
+
+    const QByteArray version = "Cppcheck 1.72";
+    const QStringList arguments = {QStringLiteral("--enable=style")};
+    const QList<Path> includeDirectories = {Path(includes.path())};
+
+    const QByteArray hash = ResultCache(Path(project.path())).inputHash(source, version, arguments, includeDirectories);
+    QVERIFY(!hash.isEmpty());
+    QCOMPARE(ResultCache(Path(project.path())).inputHash(source, version, arguments, includeDirectories), hash);
+
+    // the version of cppcheck is part of the inputs
+    QVERIFY(ResultCache(Path(project.path())).inputHash(source, "Cppcheck 1.80", arguments, includeDirectories) != hash);
+
+    // the arguments as well
+    QVERIFY(ResultCache(Path(project.path())).inputHash(source, version, {}, includeDirectories) != hash);
+
+    // so is the header which is only found in the include directories
+    QVERIFY(ResultCache(Path(project.path())).inputHash(source, version, arguments, {}) != hash);
+
+    // and what is included indirectly
+    writeFile(header, "int foo(int);\n");
+    QVERIFY(ResultCache(Path(project.path())).inputHash(source, version, arguments, includeDirectories) != hash);
+}
+
+void TestCppcheckResultCache::testStoreAndLoad()
+{
+    QTemporaryDir project;
+    const QString source = project.path() + QStringLiteral("/source.cpp");
+
+    ResultCache cache{Path(project.path())};
+    QStringList output;
+    QVERIFY(!cache.load(source, "hash", output));
+
+    const QStringList errors = {
+        QStringLiteral("<?xml version=\"1.0\" encoding=\"UTF-8\"?>"),
+        QStringLiteral("<results version=\"2\">"),
+        QStringLiteral("</results>")
+    };
+    cache.store(source, "hash", errors);
+
+    QVERIFY(cache.load(source, "hash", output));
+    QCOMPARE(output, errors);
+
+    // an entry is only valid for its inputs
+    QVERIFY(!cache.load(source, "other hash", output));
+}
+
+void TestCppcheckResultCache::testPrune()
+{
+    QTemporaryDir project;
+    const QString source = project.path() + QStringLiteral("/source.cpp");
+    const QString removedSource = project.path() + QStringLiteral("/removed.cpp");
+    writeFile(source, "int main() {}\n");
+
+    ResultCache cache{Path(project.path())};
+    cache.store(source, "hash", {});
+    cache.store(removedSource, "hash", {});
+
+    cache.prune();
+
+    QStringList output;
+    QVERIFY(cache.load(source, "hash", output));
+    QVERIFY(!cache.load(removedSource, "hash", output));
+}
+
+QTEST_GUILESS_MAIN(TestCppcheckResultCache)
@@ -261,6 +261,7 @@ void ClangParseJob::run(ThreadWeaver::JobPointer /*self*/, ThreadWeaver::Thread*
             return;
         }
         ctx->setAst(IAstContainer::Ptr(session.data()));
+        clang()->index()->touchAttachedAst(m_environment.translationUnitUrl(), session.data().data());
 
         if (minimumFeatures() & UpdateHighlighting) {
             lock.unlock();
@@ -276,14 +277,27 @@ void ClangParseJob::run(ThreadWeaver::JobPointer /*self*/, ThreadWeaver::Thread*
         }
     }
 
+    if (reparseForCodeCompletion()) {
+        return;
+    }
+
     ParseSession session(ClangIntegration::DUChainUtils::findParseSessionData(document(), m_environment.translationUnitUrl()));
     if (abortRequested()) {
         return;
     }
 
-    if (!session.data() || !session.reparse(m_unsavedFiles, m_environment)) {
+    // only the DUChain update deferred by reparseForCodeCompletion() may skip the reparse,
+    // everything else might have to pick up changes the editor revisions do not cover
+    const bool deferredUpdate = parsePriority() == DeferredDUChainUpdatePriority
+                             && !(minimumFeatures() & TopDUContext::ForceUpdate);
+    if (deferredUpdate && session.isUpToDate(m_unsavedRevisions, m_environment)) {
+        // a completion-only job already reparsed the unit with the current editor contents
+        clangDebug() << "reusing up-to-date translation unit for" << document();
+    } else if (!session.data() || !session.reparse(m_unsavedFiles, m_environment)) {
         session.setData(createSessionData());
     }
+    // the unit is reused at most once
+    session.setUnsavedRevisions({});
 
     if (!session.unit()) {
         // failed to parse file, unpin and don't try again
@@ -318,9 +332,11 @@ void ClangParseJob::run(ThreadWeaver::JobPointer /*self*/, ThreadWeaver::Thread*
         return;
     }
 
+    QSet<CXFile> updatedFiles;
     auto context = ClangHelpers::buildDUChain(session.mainFile(), imports, session,
                                               minimumFeatures(), includedFiles,
-                                              clang()->index(), [this] { return abortRequested(); });
+                                              clang()->index(), [this] { return abortRequested(); },
+                                              &updatedFiles);
     setDuChain(context);
 
     if (abortRequested()) {
@@ -331,6 +347,7 @@ void ClangParseJob::run(ThreadWeaver::JobPointer /*self*/, ThreadWeaver::Thread*
         if (minimumFeatures() & TopDUContext::AST) {
             DUChainWriteLocker lock;
             context->setAst(IAstContainer::Ptr(session.data()));
+            clang()->index()->touchAttachedAst(m_environment.translationUnitUrl(), session.data().data());
         }
 #ifdef QT_DEBUG
         DUChainReadLocker lock;
@@ -344,7 +361,8 @@ void ClangParseJob::run(ThreadWeaver::JobPointer /*self*/, ThreadWeaver::Thread*
 #endif
     }
 
-    foreach(const auto& context, includedFiles) {
+    for (auto it = includedFiles.constBegin(); it != includedFiles.constEnd(); ++it) {
+        const auto& context = it.value();
         if (!context) {
             continue;
         }
@@ -368,12 +386,53 @@ void ClangParseJob::run(ThreadWeaver::JobPointer /*self*/, ThreadWeaver::Thread*
                 // share the session data with all contexts that are pinned to this TU
                 DUChainWriteLocker lock;
                 context->setAst(IAstContainer::Ptr(session.data()));
+                clang()->index()->touchAttachedAst(m_environment.translationUnitUrl(), session.data().data());
+            }
+            // the highlighting of other open files whose contexts were not rebuilt is still up to date,
+            // recomputing and reapplying it after every parse is expensive for large files
+            if (context->url() == document() || updatedFiles.contains(it.key())) {
+                languageSupport()->codeHighlighting()->highlightDUChain(context);
             }
-            languageSupport()->codeHighlighting()->highlightDUChain(context);
         }
     }
 }
 
+bool ClangParseJob::reparseForCodeCompletion()
+{
+    // only the documents edited by the user take the fast path, everything else
+    // (opening files, project parsing, recursive updates) runs the full pipeline
+    if (parsePriority() >= DeferredDUChainUpdatePriority
+        || (minimumFeatures() & (Rescheduled | TopDUContext::ForceUpdateRecursive))
+        || !m_tuDocumentIsUnsaved || document() != m_environment.translationUnitUrl()
+        || !trackerForUrl(document()))
+    {
+        return false;
+    }
+
+    auto sessionData = ClangIntegration::DUChainUtils::findParseSessionData(document(), m_environment.translationUnitUrl());
+    if (!sessionData) {
+        return false;
+    }
+
+    {
+        ParseSession session(sessionData);
+        if (abortRequested() || !session.reparse(m_unsavedFiles, m_environment)) {
+            // let the full pipeline sort out the broken or outdated unit
+            return false;
+        }
+        session.setUnsavedRevisions(m_unsavedRevisions);
+        clang()->index()->touchAttachedAst(m_environment.translationUnitUrl(), sessionData.data());
+        // releasing the session here makes the reparsed unit available to code completion right away
+    }
+
+    clangDebug() << "reparsed" << document() << "for code completion, deferring DUChain update";
+    ICore::self()->languageController()->backgroundParser()->addDocument(document(), minimumFeatures(),
+                                                                         DeferredDUChainUpdatePriority,
+                                                                         nullptr, ParseJob::IgnoresSequentialProcessing,
+                                                                         DeferredDUChainUpdateDelay);
+    return true;
+}
+
 ParseSessionData::Ptr ClangParseJob::createSessionData() const
 {
     return ParseSessionData::Ptr(new ParseSessionData(m_unsavedFiles, clang()->index(), m_environment, ParseSessionData::NoOption));
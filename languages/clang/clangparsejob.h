@@ -26,6 +26,7 @@
 #include <QHash>
 
 #include <language/backgroundparser/parsejob.h>
+#include <language/backgroundparser/backgroundparser.h>
 #include "duchain/clangparsingenvironment.h"
 #include "duchain/unsavedfile.h"
 
@@ -46,6 +47,19 @@ public:
         UpdateHighlighting = (AttachASTWithoutUpdating << 1) ///< Used when we only need to update highlighting
     };
 
+    /**
+     * Priority of the deferred DUChain update which follows a completion-only reparse.
+     *
+     * Jobs of the editor's active documents that run with a better priority only reparse
+     * the attached translation unit, which is all that code completion needs, and
+     * reschedule the DUChain update with this priority, after DeferredDUChainUpdateDelay
+     * milliseconds. Edits made in the meantime then coalesce into a single DUChain update.
+     */
+    enum {
+        DeferredDUChainUpdatePriority = KDevelop::BackgroundParser::NormalPriority + 1,
+        DeferredDUChainUpdateDelay = 1000
+    };
+
 protected:
     void run(ThreadWeaver::JobPointer self, ThreadWeaver::Thread *thread) override;
 
@@ -54,6 +68,14 @@ protected:
 private:
     QExplicitlySharedDataPointer<ParseSessionData> createSessionData() const;
 
+    /**
+     * Reparse the translation unit attached to the document, without updating the DUChain.
+     *
+     * @return true when the reparse was done and the DUChain update got deferred,
+     *         false when the full parse pipeline has to run instead
+     */
+    bool reparseForCodeCompletion();
+
     ClangParsingEnvironment m_environment;
     QVector<UnsavedFile> m_unsavedFiles;
     bool m_tuDocumentIsUnsaved = false;
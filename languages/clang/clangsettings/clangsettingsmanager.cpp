@@ -48,6 +48,8 @@ namespace
 
     const QString forwardDeclare = QStringLiteral("forwardDeclare");
 
+    const QString astMemoryBudget = QStringLiteral("astMemoryBudget");
+
 AssistantsSettings readAssistantsSettings(KConfig* cfg)
 {
     auto grp = cfg->group(settingsGroup);
@@ -68,6 +70,16 @@ CodeCompletionSettings readCodeCompletionSettings(KConfig* cfg)
 
     return settings;
 }
+
+MemorySettings readMemorySettings(KConfig* cfg)
+{
+    auto grp = cfg->group(settingsGroup);
+    MemorySettings settings;
+
+    settings.astMemoryBudget = qMax(0, grp.readEntry(astMemoryBudget, 2048));
+
+    return settings;
+}
 }
 
 ClangSettingsManager* ClangSettingsManager::self()
@@ -95,6 +107,18 @@ CodeCompletionSettings ClangSettingsManager::codeCompletionSettings() const
     return readCodeCompletionSettings(cfg.data());
 }
 
+MemorySettings ClangSettingsManager::memorySettings() const
+{
+    if (m_enableTesting) {
+        MemorySettings settings;
+        settings.astMemoryBudget = 0;
+        return settings;
+    }
+
+    auto cfg = ICore::self()->activeSession()->config();
+    return readMemorySettings(cfg.data());
+}
+
 ParserSettings ClangSettingsManager::parserSettings(KDevelop::ProjectBaseItem* item) const
 {
     return {IDefinesAndIncludesManager::manager()->parserArguments(item)};
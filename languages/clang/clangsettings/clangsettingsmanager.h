@@ -57,6 +57,12 @@ struct AssistantsSettings
     bool forwardDeclare = true;
 };
 
+struct MemorySettings
+{
+    /// Memory budget in MiB for the ASTs attached to open documents, 0 means unlimited
+    int astMemoryBudget = 2048;
+};
+
 class KDEVCLANGPRIVATE_EXPORT ClangSettingsManager
 {
 public:
@@ -66,6 +72,8 @@ public:
 
     CodeCompletionSettings codeCompletionSettings() const;
 
+    MemorySettings memorySettings() const;
+
     ParserSettings parserSettings(KDevelop::ProjectBaseItem* item) const;
 
     ParserSettings parserSettings(const QString& path) const;
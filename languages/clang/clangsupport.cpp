@@ -39,6 +39,7 @@
 #include <interfaces/iplugincontroller.h>
 #include <interfaces/contextmenuextension.h>
 #include <interfaces/idocumentcontroller.h>
+#include <interfaces/iuicontroller.h>
 #include <language/interfaces/iastcontainer.h>
 
 #include "codegen/clangrefactoring.h"
@@ -64,9 +65,13 @@
 #include <language/duchain/use.h>
 #include <language/editor/documentcursor.h>
 
+#include "clangsettings/clangsettingsmanager.h"
 #include "clangsettings/sessionsettings/sessionsettings.h"
+#include "sessionconfig.h"
 
 #include <KActionCollection>
+#include <KFormat>
+#include <KMessageBox>
 #include <KPluginFactory>
 
 #include <KTextEditor/View>
@@ -203,6 +208,12 @@ ClangSupport::ClangSupport(QObject* parent, const QVariantList& )
 
     connect(ICore::self()->documentController(), &IDocumentController::documentActivated,
             this, &ClangSupport::documentActivated);
+    connect(ICore::self()->languageController()->backgroundParser(), &BackgroundParser::parseJobFinished,
+            this, &ClangSupport::enforceAstMemoryBudget);
+
+    updateAstMemoryBudget();
+    connect(SessionConfig::self(), &SessionConfig::configChanged,
+            this, &ClangSupport::updateAstMemoryBudget);
 }
 
 ClangSupport::~ClangSupport()
@@ -289,6 +300,11 @@ void ClangSupport::createActionsForMainWindow (Sublime::MainWindow* /*window*/,
     actions.setDefaultShortcut(moveIntoSourceAction, Qt::CTRL | Qt::ALT | Qt::Key_S);
     connect(moveIntoSourceAction, &QAction::triggered,
             m_refactoring, &ClangRefactoring::executeMoveIntoSourceAction);
+
+    QAction* astMemoryUsageAction = actions.addAction(QStringLiteral("code_show_ast_memory_usage"));
+    astMemoryUsageAction->setText(i18n("Show AST Memory Usage"));
+    connect(astMemoryUsageAction, &QAction::triggered,
+            this, &ClangSupport::showAstMemoryUsage);
 }
 
 KDevelop::ContextMenuExtension ClangSupport::contextMenuExtension(KDevelop::Context* context)
@@ -420,6 +436,99 @@ int ClangSupport::suggestedReparseDelayForChange(KTextEditor::Document* /*doc*/,
     return 3000;
 }
 
+bool ClangSupport::isTranslationUnitVisible(const IndexedString& tu)
+{
+    foreach (auto document, ICore::self()->documentController()->openDocuments()) {
+        auto textDocument = document->textDocument();
+        if (!textDocument) {
+            continue;
+        }
+        const IndexedString url(document->url());
+        if (url != tu && index()->translationUnitForUrl(url) != tu) {
+            continue;
+        }
+        foreach (auto view, textDocument->views()) {
+            if (view->isVisible()) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void ClangSupport::detachAst(const IndexedString& tu)
+{
+    QVector<IndexedString> urls = {tu};
+    foreach (auto document, ICore::self()->documentController()->openDocuments()) {
+        const IndexedString url(document->url());
+        if (url != tu && index()->translationUnitForUrl(url) == tu) {
+            urls.append(url);
+        }
+    }
+
+    const auto sessionData = ClangIntegration::DUChainUtils::findParseSessionData(tu, tu);
+
+    DUChainWriteLocker lock;
+    foreach (const auto& url, urls) {
+        auto ctx = DUChainUtils::standardContextForUrl(url.toUrl());
+        if (ctx && ctx->ast() && (!sessionData || ctx->ast().data() == sessionData.data())) {
+            ctx->setAst({});
+        }
+    }
+    index()->removeAttachedAst(tu);
+}
+
+void ClangSupport::updateAstMemoryBudget()
+{
+    m_astMemoryBudget = quint64(ClangSettingsManager::self()->memorySettings().astMemoryBudget) * 1024 * 1024;
+}
+
+void ClangSupport::enforceAstMemoryBudget()
+{
+    const quint64 budget = m_astMemoryBudget;
+    if (!budget) {
+        return;
+    }
+
+    const auto asts = index()->attachedAsts();
+    quint64 memoryUsage = 0;
+    foreach (const auto& ast, asts) {
+        memoryUsage += ast.memoryUsage;
+    }
+
+    // least recently used first, the ASTs get recreated in documentActivated when needed again
+    foreach (const auto& ast, asts) {
+        if (memoryUsage <= budget) {
+            break;
+        }
+        if (isTranslationUnitVisible(ast.translationUnit)) {
+            continue;
+        }
+        clangDebug() << "releasing AST of" << ast.translationUnit << "using" << ast.memoryUsage << "bytes";
+        detachAst(ast.translationUnit);
+        memoryUsage -= ast.memoryUsage;
+    }
+}
+
+void ClangSupport::showAstMemoryUsage()
+{
+    const auto asts = index()->attachedAsts();
+    KFormat format;
+    quint64 memoryUsage = 0;
+    QStringList lines;
+    // most recently used first
+    for (auto it = asts.rbegin(); it != asts.rend(); ++it) {
+        memoryUsage += it->memoryUsage;
+        lines << i18nc("document: memory usage", "%1: %2", it->translationUnit.str(), format.formatByteSize(it->memoryUsage));
+    }
+
+    const auto budgetText = m_astMemoryBudget ? format.formatByteSize(m_astMemoryBudget) : i18n("unlimited");
+    KMessageBox::information(ICore::self()->uiController()->activeMainWindow(),
+                             i18n("ASTs attached to open documents use %1 (budget: %2).\n\n%3",
+                                  format.formatByteSize(memoryUsage), budgetText, lines.join(QLatin1Char('\n'))),
+                             i18n("AST Memory Usage"));
+}
+
 void ClangSupport::disableKeywordCompletion(KTextEditor::View* view)
 {
     setKeywordCompletion(view, false);
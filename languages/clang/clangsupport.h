@@ -36,6 +36,7 @@ class ClangRefactoring;
 namespace KDevelop
 {
 class IDocument;
+class IndexedString;
 }
 
 namespace KTextEditor
@@ -94,11 +95,19 @@ private slots:
     void documentActivated(KDevelop::IDocument* doc);
     void disableKeywordCompletion(KTextEditor::View* view);
     void enableKeywordCompletion(KTextEditor::View* view);
+    void updateAstMemoryBudget();
+    void enforceAstMemoryBudget();
+    void showAstMemoryUsage();
 
 private:
+    bool isTranslationUnitVisible(const KDevelop::IndexedString& tu);
+    void detachAst(const KDevelop::IndexedString& tu);
+
     KDevelop::ICodeHighlighting *m_highlighting;
     ClangRefactoring *m_refactoring;
     QScopedPointer<ClangIndex> m_index;
+    /// the memory budget of the attached ASTs in bytes, 0 means unlimited
+    quint64 m_astMemoryBudget = 0;
 };
 
 #endif
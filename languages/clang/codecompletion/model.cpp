@@ -95,13 +95,15 @@ public slots:
             return;
         }
 
-        ParseSessionData::Ptr sessionData(ClangIntegration::DUChainUtils::findParseSessionData(top->url(), m_index->translationUnitForUrl(top->url())));
+        const auto tuUrl = m_index->translationUnitForUrl(top->url());
+        ParseSessionData::Ptr sessionData(ClangIntegration::DUChainUtils::findParseSessionData(top->url(), tuUrl));
 
         if (!sessionData) {
             // TODO: trigger reparse and re-request code completion
             qCWarning(KDEV_CLANG) << "No parse session / AST attached to context for url" << url;
             return;
         }
+        m_index->touchAttachedAst(tuUrl, sessionData.data());
 
         if (aborting()) {
             failed();
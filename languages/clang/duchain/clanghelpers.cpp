@@ -100,7 +100,8 @@ bool importLocationLessThan(const Import& lhs, const Import& rhs)
 
 ReferencedTopDUContext ClangHelpers::buildDUChain(CXFile file, const Imports& imports, const ParseSession& session,
                                                   TopDUContext::Features features, IncludeFileContexts& includedFiles,
-                                                  ClangIndex* index, const std::function<bool()>& abortFunction)
+                                                  ClangIndex* index, const std::function<bool()>& abortFunction,
+                                                  QSet<CXFile>* updatedFiles)
 {
     if (includedFiles.contains(file)) {
         return {};
@@ -118,7 +119,7 @@ ReferencedTopDUContext ClangHelpers::buildDUChain(CXFile file, const Imports& im
     std::sort(sortedImports.begin(), sortedImports.end(), importLocationLessThan);
 
     foreach(const auto& import, sortedImports) {
-        buildDUChain(import.file, imports, session, features, includedFiles, index, abortFunction);
+        buildDUChain(import.file, imports, session, features, includedFiles, index, abortFunction, updatedFiles);
     }
 
     const IndexedString path(QDir(ClangString(clang_getFileName(file)).toString()).canonicalPath());
@@ -188,6 +189,10 @@ ReferencedTopDUContext ClangHelpers::buildDUChain(CXFile file, const Imports& im
 
     Builder::visit(session.unit(), file, includedFiles, update);
 
+    if (updatedFiles) {
+        updatedFiles->insert(file);
+    }
+
     DUChain::self()->emitUpdateReady(path, context);
 
     return context;
@@ -29,6 +29,8 @@
 
 #include <clang-c/Index.h>
 
+#include <QSet>
+
 #include <functional>
 
 class ParseSession;
@@ -71,12 +73,14 @@ KDEVCLANGPRIVATE_EXPORT Imports tuImports(CXTranslationUnit tu);
  * Recursively builds a duchain with the specified @a features for the
  * @a file and each of its @a imports using the TU from @a session.
  * The resulting contexts are placed in @a includedFiles.
+ * If @a updatedFiles is set, the files whose contexts got (re)built are added to it.
  * @returns the context created for @a file
  */
 KDEVCLANGPRIVATE_EXPORT KDevelop::ReferencedTopDUContext buildDUChain(
     CXFile file, const Imports& imports, const ParseSession& session,
     KDevelop::TopDUContext::Features features, IncludeFileContexts& includedFiles,
-    ClangIndex* index = nullptr, const std::function<bool()>& abortFunction = {});
+    ClangIndex* index = nullptr, const std::function<bool()>& abortFunction = {},
+    QSet<CXFile>* updatedFiles = nullptr);
 
 /**
  * @return List of possible header extensions used for definition/declaration fallback switching
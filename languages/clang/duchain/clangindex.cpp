@@ -24,6 +24,7 @@
 #include "clangpch.h"
 #include "clangparsingenvironment.h"
 #include "documentfinderhelpers.h"
+#include "parsesession.h"
 
 #include <util/path.h>
 #include <util/clangtypes.h>
@@ -34,6 +35,8 @@
 
 #include <clang-c/Index.h>
 
+#include <algorithm>
+
 using namespace KDevelop;
 
 ClangIndex::ClangIndex()
@@ -144,6 +147,39 @@ void ClangIndex::pinTranslationUnitForUrl(const IndexedString& tu, const Indexed
 
 void ClangIndex::unpinTranslationUnitForUrl(const IndexedString& url)
 {
-    QMutexLocker lock(&m_mappingMutex);
-    m_tuForUrl.remove(url);
+    {
+        QMutexLocker lock(&m_mappingMutex);
+        m_tuForUrl.remove(url);
+    }
+    // the unit of the url failed to parse or is gone
+    removeAttachedAst(url);
+}
+
+void ClangIndex::touchAttachedAst(const IndexedString& tu, const ParseSessionData* session)
+{
+    QMutexLocker lock(&m_astMutex);
+    auto it = std::find_if(m_attachedAsts.begin(), m_attachedAsts.end(), [&tu] (const AttachedAst& ast) {
+        return ast.translationUnit == tu;
+    });
+    if (it != m_attachedAsts.end()) {
+        m_attachedAsts.erase(it);
+    }
+    m_attachedAsts.append({tu, session, session->memoryUsage()});
+}
+
+void ClangIndex::removeAttachedAst(const IndexedString& tu, const ParseSessionData* session)
+{
+    QMutexLocker lock(&m_astMutex);
+    auto it = std::find_if(m_attachedAsts.begin(), m_attachedAsts.end(), [&tu, session] (const AttachedAst& ast) {
+        return ast.translationUnit == tu && (!session || ast.session == session);
+    });
+    if (it != m_attachedAsts.end()) {
+        m_attachedAsts.erase(it);
+    }
+}
+
+QVector<ClangIndex::AttachedAst> ClangIndex::attachedAsts() const
+{
+    QMutexLocker lock(&m_astMutex);
+    return m_attachedAsts;
 }
@@ -31,11 +31,13 @@
 
 #include <QReadWriteLock>
 #include <QSharedPointer>
+#include <QVector>
 
 #include <clang-c/Index.h>
 
 class ClangParsingEnvironment;
 class ClangPCH;
+class ParseSessionData;
 
 class KDEVCLANGPRIVATE_EXPORT ClangIndex
 {
@@ -70,9 +72,43 @@ public:
      */
     void unpinTranslationUnitForUrl(const KDevelop::IndexedString& url);
 
+    struct AttachedAst
+    {
+        KDevelop::IndexedString translationUnit;
+        /// the session data of the AST, only used to identify it
+        const ParseSessionData* session;
+        /// memory used by the AST in bytes
+        quint64 memoryUsage;
+    };
+
+    /**
+     * Mark the AST of @p tu in @p session, which is attached to the DUChain, as most recently used
+     *
+     * This function is thread safe.
+     */
+    void touchAttachedAst(const KDevelop::IndexedString& tu, const ParseSessionData* session);
+
+    /**
+     * Forget about the AST of @p tu, e.g. after it was detached from the DUChain
+     *
+     * If @p session is given, the AST is only forgotten if it belongs to it. This
+     * function is thread safe.
+     */
+    void removeAttachedAst(const KDevelop::IndexedString& tu, const ParseSessionData* session = nullptr);
+
+    /**
+     * @returns the ASTs attached to the DUChain, ordered from least to most recently used
+     */
+    QVector<AttachedAst> attachedAsts() const;
+
 private:
     CXIndex m_index;
 
+    // declared before m_pch, whose session data removes itself from it on destruction
+    mutable QMutex m_astMutex;
+    /// least recently used first
+    QVector<AttachedAst> m_attachedAsts;
+
     QReadWriteLock m_pchLock;
     QHash<KDevelop::Path, QSharedPointer<const ClangPCH>> m_pch;
 
@@ -176,6 +176,8 @@ ParseSessionData::ParseSessionData(const QVector<UnsavedFile>& unsavedFiles, Cla
                                    const ClangParsingEnvironment& environment, Options options)
     : m_file(nullptr)
     , m_unit(nullptr)
+    , m_index(index)
+    , m_tu(environment.translationUnitUrl())
 {
     unsigned int flags = CXTranslationUnit_CXXChainedPCH
         | CXTranslationUnit_DetailedPreprocessingRecord
@@ -304,6 +306,7 @@ ParseSessionData::ParseSessionData(const QVector<UnsavedFile>& unsavedFiles, Cla
 
 ParseSessionData::~ParseSessionData()
 {
+    m_index->removeAttachedAst(m_tu, this);
     clang_disposeTranslationUnit(m_unit);
 }
 
@@ -325,11 +328,51 @@ QByteArray ParseSessionData::writeDefinesFile(const QMap<QString, QString>& defi
 void ParseSessionData::setUnit(CXTranslationUnit unit)
 {
     m_unit = unit;
+    m_diagnosticsForFile.clear();
+    m_includeFileNotFoundDiagnostics.clear();
+    m_diagnosticsIndexed = false;
     if (m_unit) {
         const ClangString unitFile(clang_getTranslationUnitSpelling(unit));
         m_file = clang_getFile(m_unit, unitFile.c_str());
+
+        quintptr memoryUsage = 0;
+        CXTUResourceUsage usage = clang_getCXTUResourceUsage(m_unit);
+        for (unsigned i = 0; i < usage.numEntries; ++i) {
+            memoryUsage += usage.entries[i].amount;
+        }
+        clang_disposeCXTUResourceUsage(usage);
+        m_memoryUsage.store(memoryUsage);
     } else {
         m_file = nullptr;
+        m_memoryUsage.store(0);
+    }
+}
+
+quint64 ParseSessionData::memoryUsage() const
+{
+    return m_memoryUsage.load();
+}
+
+void ParseSessionData::indexDiagnostics()
+{
+    if (m_diagnosticsIndexed) {
+        return;
+    }
+    m_diagnosticsIndexed = true;
+
+    const uint numDiagnostics = clang_getNumDiagnostics(m_unit);
+    for (uint i = 0; i < numDiagnostics; ++i) {
+        auto diagnostic = clang_getDiagnostic(m_unit, i);
+
+        CXSourceLocation location = clang_getDiagnosticLocation(diagnostic);
+        CXFile diagnosticFile;
+        clang_getFileLocation(location, &diagnosticFile, nullptr, nullptr, nullptr);
+        m_diagnosticsForFile[diagnosticFile].append(i);
+        if (ClangDiagnosticEvaluator::diagnosticType(diagnostic) == ClangDiagnosticEvaluator::IncludeFileNotFoundProblem) {
+            m_includeFileNotFoundDiagnostics.append(i);
+        }
+
+        clang_disposeDiagnostic(diagnostic);
     }
 }
 
@@ -392,19 +435,24 @@ QList<ProblemPointer> ParseSession::problemsForFile(CXFile file) const
     QList<ProblemPointer> problems;
 
     // extra clang diagnostics
-    const uint numDiagnostics = clang_getNumDiagnostics(d->m_unit);
-    problems.reserve(numDiagnostics);
-    for (uint i = 0; i < numDiagnostics; ++i) {
-        auto diagnostic = clang_getDiagnostic(d->m_unit, i);
-
-        CXSourceLocation location = clang_getDiagnosticLocation(diagnostic);
-        CXFile diagnosticFile;
-        clang_getFileLocation(location, &diagnosticFile, nullptr, nullptr, nullptr);
-        // missing-include problems are so severe in clang that we always propagate
-        // them to this document, to ensure that the user will see the error.
-        if (diagnosticFile != file && ClangDiagnosticEvaluator::diagnosticType(diagnostic) != ClangDiagnosticEvaluator::IncludeFileNotFoundProblem) {
-            continue;
+    // the diagnostics are bucketed by file once per unit, as this function gets called
+    // for every file of the unit and we don't want to look at all diagnostics each time
+    d->indexDiagnostics();
+    auto diagnostics = d->m_diagnosticsForFile.value(file);
+    // missing-include problems are so severe in clang that we always propagate
+    // them to this document, to ensure that the user will see the error.
+    if (!d->m_includeFileNotFoundDiagnostics.isEmpty()) {
+        foreach (uint i, d->m_includeFileNotFoundDiagnostics) {
+            if (!diagnostics.contains(i)) {
+                diagnostics.append(i);
+            }
         }
+        std::sort(diagnostics.begin(), diagnostics.end());
+    }
+
+    problems.reserve(diagnostics.size());
+    foreach (uint i, diagnostics) {
+        auto diagnostic = clang_getDiagnostic(d->m_unit, i);
 
         ProblemPointer problem(ClangDiagnosticEvaluator::createProblem(diagnostic, d->m_unit));
         problems << problem;
@@ -462,6 +510,7 @@ bool ParseSession::reparse(const QVector<UnsavedFile>& unsavedFiles, const Clang
     }
 
     auto unsaved = toClangApi(unsavedFiles);
+    d->m_unsavedRevisions.clear();
 
     const auto code = clang_reparseTranslationUnit(d->m_unit, unsaved.size(), unsaved.data(),
                                                    clang_defaultReparseOptions(d->m_unit));
@@ -478,6 +527,21 @@ bool ParseSession::reparse(const QVector<UnsavedFile>& unsavedFiles, const Clang
     return true;
 }
 
+void ParseSession::setUnsavedRevisions(const QHash<IndexedString, ModificationRevision>& revisions)
+{
+    if (d) {
+        d->m_unsavedRevisions = revisions;
+    }
+}
+
+bool ParseSession::isUpToDate(const QHash<IndexedString, ModificationRevision>& revisions,
+                              const ClangParsingEnvironment& environment) const
+{
+    return d && d->m_unit && !revisions.isEmpty()
+        && environment == d->m_environment
+        && revisions == d->m_unsavedRevisions;
+}
+
 ClangParsingEnvironment ParseSession::environment() const
 {
     return d->m_environment;
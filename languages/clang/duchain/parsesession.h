@@ -26,6 +26,7 @@
 #include <QList>
 #include <QUrl>
 #include <QTemporaryFile>
+#include <QAtomicInteger>
 
 #include <clang-c/Index.h>
 
@@ -34,6 +35,7 @@
 #include <util/path.h>
 
 #include <language/duchain/problem.h>
+#include <language/duchain/modificationrevision.h>
 #include <language/interfaces/iastcontainer.h>
 
 #include "clangprivateexport.h"
@@ -67,16 +69,37 @@ public:
 
     ClangParsingEnvironment environment() const;
 
+    /**
+     * @return the memory in bytes used by the translation unit, as of the last (re)parse
+     *
+     * This function is thread safe and does not require the session to be locked.
+     */
+    quint64 memoryUsage() const;
+
 private:
     friend class ParseSession;
     void setUnit(CXTranslationUnit unit);
     QByteArray writeDefinesFile(const QMap<QString, QString>& defines);
+    void indexDiagnostics();
 
     QMutex m_mutex;
 
+    /// the editor revisions of the unsaved files the unit was last (re)parsed with
+    QHash<KDevelop::IndexedString, KDevelop::ModificationRevision> m_unsavedRevisions;
+
+    /// the diagnostics of the unit per file, indexed lazily when the problems are first requested
+    QHash<CXFile, QVector<uint>> m_diagnosticsForFile;
+    /// missing include diagnostics, these get propagated to all files of the unit
+    QVector<uint> m_includeFileNotFoundDiagnostics;
+    bool m_diagnosticsIndexed = false;
+
     CXFile m_file = nullptr;
     CXTranslationUnit m_unit = nullptr;
+    QAtomicInteger<quintptr> m_memoryUsage;
     ClangParsingEnvironment m_environment;
+    /// the index the unit was parsed in, which tracks it while it is attached to the DUChain
+    ClangIndex* m_index;
+    KDevelop::IndexedString m_tu;
     /// TODO: share this file for all TUs that use the same defines (probably most in a project)
     ///       best would be a PCH, if possible
     QTemporaryFile m_definesFile;
@@ -127,6 +150,18 @@ public:
 
     bool reparse(const QVector<UnsavedFile>& unsavedFiles, const ClangParsingEnvironment& environment);
 
+    /**
+     * Remember the editor revisions of the unsaved files the unit was last (re)parsed with.
+     */
+    void setUnsavedRevisions(const QHash<KDevelop::IndexedString, KDevelop::ModificationRevision>& revisions);
+
+    /**
+     * @return true when the unit was already (re)parsed with exactly the given editor revisions,
+     *         i.e. reparsing it again would not change anything.
+     */
+    bool isUpToDate(const QHash<KDevelop::IndexedString, KDevelop::ModificationRevision>& revisions,
+                    const ClangParsingEnvironment& environment) const;
+
     ClangParsingEnvironment environment() const;
 
 private:
@@ -39,16 +39,10 @@ using namespace KDevelop;
 
 namespace {
 
-inline int findEndOfLineOrEnd(const QString& str, int from = 0)
+inline int findEndOfLineOrEnd(const char* str, int length, int from = 0)
 {
-    const int index = str.indexOf(QLatin1Char('\n'), from);
-    return (index == -1 ? str.length() : index);
-}
-
-inline int findBeginningOfLineOrStart(const QString& str, int from = 0)
-{
-    const int index = str.lastIndexOf(QLatin1Char('\n'), from);
-    return (index == -1 ? 0 : index+1);
+    const auto end = std::find(str + from, str + length, '\n');
+    return end - str;
 }
 
 inline int findEndOfCommentOrEnd(const QString& str, int from = 0)
@@ -57,6 +51,119 @@ inline int findEndOfCommentOrEnd(const QString& str, int from = 0)
     return (index == -1 ? str.length() : index);
 }
 
+/**
+ * @brief Aho-Corasick automaton matching all to-do marker words in a single pass
+ *
+ * The automaton operates on the UTF-8 encoded bytes as returned by libclang,
+ * such that the comment text only needs to be decoded where a marker was found.
+ */
+class TodoMarkerMatcher
+{
+public:
+    explicit TodoMarkerMatcher(const QStringList& markerWords)
+    {
+        addState();
+        foreach (const QString& markerWord, markerWords) {
+            const QByteArray word = markerWord.toUtf8();
+            if (word.isEmpty()) {
+                continue;
+            }
+            int state = 0;
+            for (const char c : word) {
+                int& next = m_transitions[state * AlphabetSize + static_cast<uchar>(c)];
+                if (next == NoTransition) {
+                    next = addState();
+                }
+                state = next;
+            }
+            m_matchLength[state] = qMax(m_matchLength[state], word.size());
+        }
+        buildFailureTransitions();
+    }
+
+    bool isEmpty() const
+    {
+        return m_matchLength.size() == 1;
+    }
+
+    inline int next(int state, char c) const
+    {
+        return m_transitions[state * AlphabetSize + static_cast<uchar>(c)];
+    }
+
+    /**
+     * @return the length of the longest marker word ending in @p state, or 0 when there is none
+     */
+    inline int matchLength(int state) const
+    {
+        return m_matchLength[state];
+    }
+
+    /**
+     * @return true when any of the marker words occurs in the range [@p begin, @p end)
+     */
+    bool containsMarker(const char* begin, const char* end) const
+    {
+        int state = 0;
+        for (auto it = begin; it != end; ++it) {
+            state = next(state, *it);
+            if (m_matchLength[state]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    enum {
+        AlphabetSize = 256,
+        NoTransition = -1
+    };
+
+    int addState()
+    {
+        m_transitions.insert(m_transitions.size(), AlphabetSize, NoTransition);
+        m_matchLength.append(0);
+        return m_matchLength.size() - 1;
+    }
+
+    /// turn the trie into a deterministic automaton, resolving all failure links
+    void buildFailureTransitions()
+    {
+        QVector<int> failure(m_matchLength.size(), 0);
+        QVector<int> queue;
+        queue.reserve(m_matchLength.size());
+
+        for (int c = 0; c < AlphabetSize; ++c) {
+            int& next = m_transitions[c];
+            if (next == NoTransition) {
+                next = 0;
+            } else {
+                queue.append(next);
+            }
+        }
+
+        for (int i = 0; i < queue.size(); ++i) {
+            const int state = queue.at(i);
+            // a match of a shorter marker word ending here is a match, too
+            m_matchLength[state] = qMax(m_matchLength[state], m_matchLength[failure[state]]);
+            for (int c = 0; c < AlphabetSize; ++c) {
+                int& next = m_transitions[state * AlphabetSize + c];
+                const int fallback = m_transitions[failure[state] * AlphabetSize + c];
+                if (next == NoTransition) {
+                    next = fallback;
+                } else {
+                    failure[next] = fallback;
+                    queue.append(next);
+                }
+            }
+        }
+    }
+
+    QVector<int> m_transitions;
+    QVector<int> m_matchLength;
+};
+
 /**
  * @brief Class for parsing to-do items out of a given comment string
  *
@@ -75,11 +182,12 @@ public:
         KTextEditor::Range localRange;
     };
 
-    CommentTodoParser(const QString& str, const QStringList& markerWords)
+    CommentTodoParser(const char* str, int length, const TodoMarkerMatcher& matcher)
         : m_str(str)
-        , m_todoMarkerWords(markerWords)
+        , m_length(length)
+        , m_matcher(matcher)
     {
-        skipUntilMarkerWord();
+        parse();
     }
 
     QVector<Result> results() const
@@ -88,62 +196,64 @@ public:
     }
 
 private:
-    void skipUntilMarkerWord()
+    void parse()
     {
         // in the most-cases, we won't find a to-do item
         // make sure this case is sufficiently fast
+        int state = 0;
+        int line = 0;
+        int lineStart = 0;
+        for (int offset = 0; offset < m_length; ++offset) {
+            const char c = m_str[offset];
+            if (c == '\n') {
+                ++line;
+                lineStart = offset + 1;
+                state = 0;
+                continue;
+            }
 
-        // for each to-do marker, scan the comment text
-        foreach (const QString& todoMarker, m_todoMarkerWords) {
-            int offset = m_str.indexOf(todoMarker, m_offset);
-            if (offset != -1) {
-                m_offset = offset;
-                parseTodoMarker();
+            state = m_matcher.next(state, c);
+            if (const int length = m_matcher.matchLength(state)) {
+                offset = parseTodoMarker(offset - length + 1, lineStart, line);
+                state = 0;
             }
         }
     }
 
-    void skipUntilNewline()
-    {
-        m_offset = findEndOfLineOrEnd(m_str, m_offset);
-    }
-
-    void parseTodoMarker()
+    /**
+     * Parse the to-do item starting at @p offset
+     *
+     * @return the offset of the end of the line the item was found on
+     */
+    int parseTodoMarker(int offset, int lineStart, int line)
     {
         // okay, we've found something
-        // m_offset points to the start of the to-do item
-        const int lineStart = findBeginningOfLineOrStart(m_str, m_offset);
-        const int lineEnd = findEndOfLineOrEnd(m_str, m_offset);
-        Q_ASSERT(lineStart <= m_offset);
-        Q_ASSERT(lineEnd > m_offset);
+        // offset points to the start of the to-do item
+        const int lineEnd = findEndOfLineOrEnd(m_str, m_length, offset);
+        Q_ASSERT(lineStart <= offset);
+        Q_ASSERT(lineEnd > offset);
 
-        QString text = m_str.mid(m_offset, lineEnd - m_offset);
+        QString text = QString::fromUtf8(m_str + offset, lineEnd - offset);
         Q_ASSERT(!text.contains(QLatin1Char('\n')));
 
         // there's nothing to be stripped on the left side, hence ignore that
         text.chop(text.length() - findEndOfCommentOrEnd(text));
         text = text.trimmed(); // remove additional whitespace from the end
 
-        // check at what line within the comment we are by just counting the newlines until now
-        const int line = std::count(m_str.constBegin(), m_str.constBegin() + m_offset, QLatin1Char('\n'));
-        KTextEditor::Cursor start = {line, m_offset - lineStart};
+        // columns are counted in UTF-16 code units, like in the editor
+        const int column = QString::fromUtf8(m_str + lineStart, offset - lineStart).length();
+        KTextEditor::Cursor start = {line, column};
         KTextEditor::Cursor end = {line, start.column() + text.length()};
         m_results << Result{text, {start, end}};
 
-        skipUntilNewline();
-        skipUntilMarkerWord();
-    }
-
-    inline bool atEnd() const
-    {
-        return m_offset < m_str.length();
+        // continue on the next line, the newline itself is handled by the caller
+        return lineEnd - 1;
     }
 
 private:
-    const QString m_str;
-    const QStringList m_todoMarkerWords;
-
-    int m_offset = 0;
+    const char* const m_str;
+    const int m_length;
+    const TodoMarkerMatcher& m_matcher;
 
     QVector<Result> m_results;
 };
@@ -162,6 +272,21 @@ void TodoExtractor::extractTodos()
 {
     using uintLimits = std::numeric_limits<uint>;
 
+    const TodoMarkerMatcher matcher(m_todoMarkerWords);
+    if (matcher.isEmpty()) {
+        return;
+    }
+
+#if CINDEX_VERSION_MINOR >= 47
+    // tokenizing the whole file is expensive, skip it when there cannot be any to-do item
+    size_t size = 0;
+    if (const char* contents = clang_getFileContents(m_unit, m_file, &size)) {
+        if (!matcher.containsMarker(contents, contents + size)) {
+            return;
+        }
+    }
+#endif
+
     auto start = clang_getLocation(m_unit, m_file, 1, 1);
     auto end = clang_getLocation(m_unit, m_file, uintLimits::max(), uintLimits::max());
 
@@ -180,12 +305,16 @@ void TodoExtractor::extractTodos()
             continue;
         }
 
-        CXString tokenSpelling = clang_getTokenSpelling(m_unit, token);
-        auto tokenRange = ClangRange(clang_getTokenExtent(m_unit, token)).toRange();
-        const QString text = ClangString(tokenSpelling).toString();
+        const ClangString spelling(clang_getTokenSpelling(m_unit, token));
+        const char* text = spelling.c_str();
+        CommentTodoParser parser(text, qstrlen(text), matcher);
+        const auto results = parser.results();
+        if (results.isEmpty()) {
+            continue;
+        }
 
-        CommentTodoParser parser(text, m_todoMarkerWords);
-        foreach (const CommentTodoParser::Result& result, parser.results()) {
+        auto tokenRange = ClangRange(clang_getTokenExtent(m_unit, token)).toRange();
+        foreach (const CommentTodoParser::Result& result, results) {
             ProblemPointer problem(new Problem);
             problem->setDescription(result.description);
             problem->setSeverity(IProblem::Hint);
@@ -406,6 +406,15 @@ void TestProblems::testTodoProblems_data()
     QTest::newRow("todo-later-in-the-document")
         << "///foo\n\n///FIXME: bar\n"
         << ExpectedTodos{{"FIXME: bar", {2, 3}, {2, 13}}};
+    QTest::newRow("different-markers")
+        << "/** TODO: one\n* foo FIXME: two */\n"
+        << ExpectedTodos{
+            {"TODO: one", {0, 4}, {0, 13}},
+            {"FIXME: two", {1, 6}, {1, 16}}
+        };
+    QTest::newRow("non-ascii-before-todo")
+        << "/* 例えば TODO: foo */"
+        << ExpectedTodos{{"TODO: foo", {0, 7}, {0, 16}}};
     QTest::newRow("non-ascii-todo")
         << "/* TODO: 例えば */"
         << ExpectedTodos{{"TODO: 例えば", {0, 3}, {0, 12}}};
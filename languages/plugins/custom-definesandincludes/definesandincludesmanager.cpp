@@ -27,8 +27,13 @@
 #include "noprojectincludesanddefines/noprojectincludepathsmanager.h"
 
 #include <interfaces/icore.h>
+#include <interfaces/idocumentcontroller.h>
+#include <interfaces/ilanguagecontroller.h>
 #include <interfaces/iprojectcontroller.h>
 #include <interfaces/iproject.h>
+#include <language/backgroundparser/backgroundparser.h>
+#include <language/duchain/topducontext.h>
+#include <serialization/indexedstring.h>
 #include <project/interfaces/ibuildsystemmanager.h>
 #include <project/projectmodel.h>
 
@@ -290,6 +295,26 @@ void DefinesAndIncludesManager::openConfigurationDialog(const QString& pathToFil
     }
 }
 
+void DefinesAndIncludesManager::projectSpecificFlagsChanged(IProject* project, const Path::List& files)
+{
+    auto parser = ICore::self()->languageController()->backgroundParser();
+    auto documentController = ICore::self()->documentController();
+
+    for (const auto& file : files) {
+        const IndexedString url(file.pathOrUrl());
+        if (!project->inProject(url)) {
+            continue;
+        }
+
+        // no ForceUpdate here: the parse job compares the environment against the stored one itself
+        if (documentController->documentForUrl(file.toUrl())) {
+            parser->addDocument(url, TopDUContext::AllDeclarationsContextsAndUses, BackgroundParser::NormalPriority);
+        } else {
+            parser->addDocument(url, TopDUContext::VisibleDeclarationsAndContexts, BackgroundParser::InitialParsePriority);
+        }
+    }
+}
+
 Path::List DefinesAndIncludesManager::includesInBackground(const QString& path) const
 {
     Path::List includes;
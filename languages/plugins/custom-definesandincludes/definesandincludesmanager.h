@@ -70,6 +70,7 @@ public:
     QString parserArguments(const QString& path) const override;
 
     void openConfigurationDialog( const QString& pathToFile ) override;
+    void projectSpecificFlagsChanged(KDevelop::IProject* project, const KDevelop::Path::List& files) override;
     int perProjectConfigPages() const override;
     KDevelop::ConfigPage* perProjectConfigPage(int number, const KDevelop::ProjectConfigOptions& options,
                                                        QWidget* parent) override;
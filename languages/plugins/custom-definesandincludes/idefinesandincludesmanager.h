@@ -196,6 +196,17 @@ public:
 
     /// Opens a configuration dialog for @p pathToFile to modify include directories/files and defined macros.
     virtual void openConfigurationDialog(const QString& pathToFile) = 0;
+
+    /**
+     * Call this when the project specific includes/defines of @p files changed, e.g. after
+     * a project manager integrated a new import and compared it against the previous one.
+     *
+     * The files are queued for reparsing without forcing an update, so language plugins
+     * only redo the work for files whose parsing environment really differs.
+     *
+     * NOTE: call it from the foreground thread only.
+     */
+    virtual void projectSpecificFlagsChanged(IProject* project, const Path::List& files) = 0;
 };
 
 inline IDefinesAndIncludesManager* IDefinesAndIncludesManager::manager()
@@ -28,6 +28,7 @@
 #include <language/codecompletion/codecompletionitem.h>
 #include <language/codecompletion/normaldeclarationcompletionitem.h>
 #include <language/duchain/declaration.h>
+#include <language/duchain/duchain.h>
 #include <language/duchain/duchainlock.h>
 #include <language/duchain/classdeclaration.h>
 #include <language/duchain/namespacealiasdeclaration.h>
@@ -41,11 +42,84 @@
 #include "../duchain/frameworks/nodejs.h"
 
 #include <QtCore/QDir>
+#include <QtCore/QMutex>
 #include <QtCore/QRegExp>
+#include <QtCore/QSet>
 #include <QtCore/QStandardPaths>
 
 using namespace KDevelop;
 
+namespace {
+
+/**
+ * Declarations offered by the modules imported in QML files, keyed by the
+ * top-context of the module and the flags used to list them.
+ *
+ * Modules like QtQuick.Controls contain hundreds of declarations, and going
+ * through them was the slowest part of every completion request. The entries
+ * of a module also contain the declarations of the modules it imports, and are
+ * dropped when any of these files is updated in the DUChain.
+ */
+class ImportCompletionCache
+{
+public:
+    typedef QPair<IndexedString, int> Key;
+
+    static ImportCompletionCache& self()
+    {
+        static ImportCompletionCache* cache = new ImportCompletionCache;
+        return *cache;
+    }
+
+    bool find(const Key& key, QmlJS::CompletionEntries* entries)
+    {
+        QMutexLocker lock(&m_mutex);
+        auto it = m_entries.constFind(key);
+
+        if (it == m_entries.constEnd()) {
+            return false;
+        }
+
+        *entries = it->entries;
+        return true;
+    }
+
+    void insert(const Key& key, const QmlJS::CompletionEntries& entries, const QSet<IndexedString>& files)
+    {
+        QMutexLocker lock(&m_mutex);
+        m_entries.insert(key, {entries, files});
+    }
+
+private:
+    ImportCompletionCache()
+    {
+        // Called from the parse threads
+        QObject::connect(DUChain::self(), &DUChain::updateReady,
+                         [this](const IndexedString& url, const ReferencedTopDUContext&) {
+            QMutexLocker lock(&m_mutex);
+
+            for (auto it = m_entries.begin(); it != m_entries.end();) {
+                if (it->files.contains(url)) {
+                    it = m_entries.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        });
+    }
+
+    struct Entry {
+        QmlJS::CompletionEntries entries;
+        /// The files declaring the entries
+        QSet<IndexedString> files;
+    };
+
+    QMutex m_mutex;
+    QHash<Key, Entry> m_entries;
+};
+
+}
+
 typedef QPair<Declaration*, int> DeclarationDepthPair;
 
 namespace QmlJS {
@@ -171,9 +245,7 @@ QList<KDevelop::CompletionTreeItemPointer> CodeCompletionContext::normalCompleti
                                           CompletionOnlyLocal | CompletionHideWrappers,
                                           CompletionItem::ColonOrBracket);
             items << completionsFromImports(CompletionHideWrappers);
-            items << completionsInContext(DUContextPointer(m_duContext->topContext()),
-                                          CompletionHideWrappers,
-                                          CompletionItem::NoDecoration);
+            items << completionsInTopContext(CompletionHideWrappers);
         } else {
             items << completionsInContext(m_duContext,
                                           nullptr,
@@ -326,6 +398,71 @@ QList<CompletionTreeItemPointer> CodeCompletionContext::completionsFromImports(C
     return items;
 }
 
+QList<CompletionTreeItemPointer> CodeCompletionContext::completionsInTopContext(CompletionInContextFlags flags)
+{
+    DUChainReadLocker lock;
+    TopDUContext* top = m_duContext->topContext();
+    QList<CompletionTreeItemPointer> items;
+
+    if (!top) {
+        return items;
+    }
+
+    // The declarations of the document itself change while it is being edited.
+    // They are listed at the same depth as allDeclarations() gives them
+    QList<DeclarationDepthPair> localDeclarations;
+
+    for (Declaration* declaration : top->localDeclarations()) {
+        localDeclarations << DeclarationDepthPair(declaration, 1000);
+    }
+
+    items << completionItems(completionEntries(DUContextPointer(top), localDeclarations,
+                                               flags, CompletionItem::NoDecoration));
+
+    // The modules imported by the document only change when they are reparsed.
+    // A module imported by several others is listed only once
+    QSet<Declaration*> listed;
+    const auto imports = top->importedParentContexts();
+
+    for (int i = imports.size() - 1; i >= 0; --i) {
+        DUContext* module = imports.at(i).context(top);
+
+        if (!module) {
+            continue;
+        }
+
+        const ImportCompletionCache::Key key(module->url(), flags);
+        CompletionEntries entries;
+
+        if (!ImportCompletionCache::self().find(key, &entries)) {
+            QSet<IndexedString> files = {module->url()};
+
+            entries = completionEntriesInContext(DUContextPointer(module), flags, CompletionItem::NoDecoration);
+
+            for (CompletionEntry& entry : entries) {
+                // One level deeper when seen from the importing document
+                ++entry.inheritanceDepth;
+                files.insert(entry.declaration->topContext()->url());
+            }
+
+            ImportCompletionCache::self().insert(key, entries, files);
+        }
+
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (listed.contains(it->declaration.data())) {
+                it = entries.erase(it);
+            } else {
+                listed.insert(it->declaration.data());
+                ++it;
+            }
+        }
+
+        items << completionItems(entries);
+    }
+
+    return items;
+}
+
 QList<CompletionTreeItemPointer> CodeCompletionContext::completionsFromNodeModule(CompletionInContextFlags flags,
                                                                                   const QString& module)
 {
@@ -341,17 +478,54 @@ QList<CompletionTreeItemPointer> CodeCompletionContext::completionsFromNodeModul
 QList<CompletionTreeItemPointer> CodeCompletionContext::completionsInContext(const DUContextPointer& context,
                                                                              CompletionInContextFlags flags,
                                                                              CompletionItem::Decoration decoration)
+{
+    return completionItems(completionEntriesInContext(context, flags, decoration));
+}
+
+QList<CompletionTreeItemPointer> CodeCompletionContext::completionItems(const CompletionEntries& entries)
 {
     QList<CompletionTreeItemPointer> items;
+
+    items.reserve(entries.size());
+
+    for (const CompletionEntry& entry : entries) {
+        // Cached entries may refer to declarations that were removed since
+        if (!entry.declaration) {
+            continue;
+        }
+
+        items << CompletionTreeItemPointer(new CompletionItem(entry.declaration, entry.inheritanceDepth, entry.decoration));
+    }
+
+    return items;
+}
+
+CompletionEntries CodeCompletionContext::completionEntriesInContext(const DUContextPointer& context,
+                                                                   CompletionInContextFlags flags,
+                                                                   CompletionItem::Decoration decoration)
+{
     DUChainReadLocker lock;
 
-    if (context) {
-        const QList<DeclarationDepthPair>& declarations = context->allDeclarations(
-            CursorInRevision::invalid(),
-            context->topContext(),
-            !flags.testFlag(CompletionOnlyLocal)
-        );
+    if (!context) {
+        return CompletionEntries();
+    }
+
+    return completionEntries(context,
+                             context->allDeclarations(CursorInRevision::invalid(),
+                                                      context->topContext(),
+                                                      !flags.testFlag(CompletionOnlyLocal)),
+                             flags,
+                             decoration);
+}
 
+CompletionEntries CodeCompletionContext::completionEntries(const DUContextPointer& context,
+                                                          const QList<DeclarationDepthPair>& declarations,
+                                                          CompletionInContextFlags flags,
+                                                          CompletionItem::Decoration decoration)
+{
+    CompletionEntries entries;
+
+    if (context) {
         foreach (const DeclarationDepthPair& decl, declarations) {
             DeclarationPointer declaration(decl.first);
             CompletionItem::Decoration decorationOfThisItem = decoration;
@@ -383,11 +557,11 @@ QList<CompletionTreeItemPointer> CodeCompletionContext::completionsInContext(con
                 }
             }
 
-            items << CompletionTreeItemPointer(new CompletionItem(declaration, decl.second, decorationOfThisItem));
+            entries.append({declaration, decl.second, decorationOfThisItem});
         }
     }
 
-    return items;
+    return entries;
 }
 
 QList<CompletionTreeItemPointer> CodeCompletionContext::fieldCompletions(const QString& expression,
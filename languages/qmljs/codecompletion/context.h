@@ -29,8 +29,23 @@
 #include <language/codecompletion/codecompletioncontext.h>
 #include <language/duchain/ducontext.h>
 
+#include <QVector>
+
 namespace QmlJS {
 
+/**
+ * @brief Declaration that can be completed, from which a CompletionItem is built
+ *
+ * Unlike completion items, these entries can be kept after the completion
+ * request that produced them, and are cached for the imported modules.
+ */
+struct CompletionEntry {
+    KDevelop::DeclarationPointer declaration;
+    int inheritanceDepth;
+    CompletionItem::Decoration decoration;
+};
+typedef QVector<CompletionEntry> CompletionEntries;
+
 class KDEVQMLJSCOMPLETION_EXPORT CodeCompletionContext : public KDevelop::CodeCompletionContext
 {
 public:
@@ -92,6 +107,15 @@ private:
     QList<KDevelop::CompletionTreeItemPointer> completionsInContext(const KDevelop::DUContextPointer& context,
                                                                     CompletionInContextFlags flags,
                                                                     CompletionItem::Decoration decoration);
+    QList<KDevelop::CompletionTreeItemPointer> completionsInTopContext(CompletionInContextFlags flags);
+    static CompletionEntries completionEntriesInContext(const KDevelop::DUContextPointer& context,
+                                                        CompletionInContextFlags flags,
+                                                        CompletionItem::Decoration decoration);
+    static CompletionEntries completionEntries(const KDevelop::DUContextPointer& context,
+                                               const QList<QPair<KDevelop::Declaration*, int>>& declarations,
+                                               CompletionInContextFlags flags,
+                                               CompletionItem::Decoration decoration);
+    static QList<KDevelop::CompletionTreeItemPointer> completionItems(const CompletionEntries& entries);
     QList<KDevelop::CompletionTreeItemPointer> fieldCompletions(const QString &expression,
                                                                 CompletionItem::Decoration decoration);
 
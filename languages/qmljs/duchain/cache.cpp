@@ -21,13 +21,44 @@
  *
  */
 #include "cache.h"
+#include "debug.h"
+#include "parsesession.h"
+
+#include <language/backgroundparser/backgroundparser.h>
 
 #include <QString>
 #include <QProcess>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QStandardPaths>
 #include <QCryptographicHash>
 #include <QCoreApplication>
+#include <QSaveFile>
+#include <QThread>
+#include <QtConcurrentRun>
+
+namespace {
+// No parse job waits for qmlplugindump, so it can take its time to load big plugins
+const int pluginDumpTimeout = 30000;
+const int pluginDumpPollInterval = 100;
+
+// The modification time of the plugin is part of the name, so that the dump
+// of a plugin is not used anymore once the plugin is updated
+QString pluginDumpFileName(const QString& filePath, const QDateTime& lastModified)
+{
+    const QByteArray key = filePath.toUtf8() + QByteArray::number(lastModified.toMSecsSinceEpoch());
+
+    return QStringLiteral("kdevqmljssupport/%1.qml").arg(
+        QString::fromLatin1(QCryptographicHash::hash(key, QCryptographicHash::Md5).toHex())
+    );
+}
+
+QString failedPluginDumpsFileName()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation)
+        + QLatin1String("/kdevqmljssupport/failedplugindumps");
+}
+}
 
 QmlJS::Cache::Cache()
 {
@@ -38,26 +69,36 @@ QmlJS::Cache::Cache()
         << PluginDumpExecutable(QStringLiteral("qmlplugindump-qt4"), QStringLiteral("1.0"))
         << PluginDumpExecutable(QStringLiteral("qmlplugindump-qt5"), QStringLiteral("2.0"))
         << PluginDumpExecutable(QStringLiteral("qml1plugindump-qt5"), QStringLiteral("1.0"));
+
+    // Each dump loads a plugin and everything it links to, don't start too many at once
+    m_pluginDumpPool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+
+    loadFailedPluginDumps();
 }
 
 QmlJS::Cache& QmlJS::Cache::instance()
 {
-    static Cache *c = nullptr;
-
-    if (!c) {
-        c = new Cache();
-    }
+    static Cache *c = new Cache();
 
     return *c;
 }
 
+QmlJS::Cache::FileShard& QmlJS::Cache::shard(const KDevelop::IndexedString& file)
+{
+    return m_shards[file.index() % ShardCount];
+}
+
 QString QmlJS::Cache::modulePath(const KDevelop::IndexedString& baseFile,
                                  const QString& uri,
                                  const QString& version)
 {
-    QMutexLocker lock(&m_mutex);
     QString cacheKey = uri + version;
-    QString path = m_modulePaths.value(cacheKey, QString());
+    QString path;
+
+    {
+        QReadLocker lock(&m_modulePathsLock);
+        path = m_modulePaths.value(cacheKey, QString());
+    }
 
     if (!path.isNull()) {
         return path;
@@ -74,7 +115,12 @@ QString QmlJS::Cache::modulePath(const KDevelop::IndexedString& baseFile,
         paths << p.cd(QStringLiteral("../imports"));
     }
 
-    paths << m_includeDirs[baseFile];
+    {
+        FileShard& fileShard = shard(baseFile);
+        QReadLocker lock(&fileShard.lock);
+
+        paths << fileShard.includeDirs.value(baseFile);
+    }
 
     // Find the path for which <path>/u/r/i exists
     QString fragment = QString(uri).replace(QLatin1Char('.'), QDir::separator());
@@ -108,11 +154,15 @@ QString QmlJS::Cache::modulePath(const KDevelop::IndexedString& baseFile,
         }
     }
 
+    // Several threads may have looked for the module, they all found the same path
+    QWriteLocker lock(&m_modulePathsLock);
+
     m_modulePaths.insert(cacheKey, path);
     return path;
 }
 
-QStringList QmlJS::Cache::getFileNames(const QFileInfoList& fileInfos)
+QStringList QmlJS::Cache::getFileNames(const QFileInfoList& fileInfos,
+                                       const KDevelop::IndexedString& requester)
 {
     QStringList result;
 
@@ -133,7 +183,7 @@ QStringList QmlJS::Cache::getFileNames(const QFileInfoList& fileInfos)
 
         // Use the cache to speed-up reparses
         {
-            QMutexLocker lock(&m_mutex);
+            QReadLocker lock(&m_modulePathsLock);
 
             if (m_modulePaths.contains(filePath)) {
                 QString cachedFilePath = m_modulePaths.value(filePath);
@@ -147,101 +197,305 @@ QStringList QmlJS::Cache::getFileNames(const QFileInfoList& fileInfos)
         }
 
         // Locate an existing dump of the file
-        QString dumpFile = QString("kdevqmljssupport/%1.qml").arg(
-            QString::fromLatin1(QCryptographicHash::hash(filePath.toUtf8(), QCryptographicHash::Md5).toHex())
-        );
         QString dumpPath = QStandardPaths::locate(QStandardPaths::GenericDataLocation,
-            dumpFile
+            pluginDumpFileName(filePath, fileInfo.lastModified())
         );
 
         if (!dumpPath.isNull()) {
-            QMutexLocker lock(&m_mutex);
+            QWriteLocker lock(&m_modulePathsLock);
 
             result.append(dumpPath);
             m_modulePaths.insert(filePath, dumpPath);
             continue;
         }
 
-        // Create a dump of the file
-        const QStringList args = {QStringLiteral("-noinstantiate"), QStringLiteral("-path"), filePath};
+        QMutexLocker lock(&m_mutex);
 
-        for (const PluginDumpExecutable& executable : m_pluginDumpExecutables) {
-            QProcess qmlplugindump;
+        // Don't try again to dump a plugin that could not be dumped, unless it changed
+        if (m_failedPluginDumps.value(filePath) == fileInfo.lastModified()) {
+            QWriteLocker modulePathsLock(&m_modulePathsLock);
 
-            qmlplugindump.setProcessChannelMode(QProcess::SeparateChannels);
-            qmlplugindump.setWorkingDirectory(fileInfo.absolutePath());
-            qmlplugindump.start(executable.executable, args);
+            m_modulePaths.insert(filePath, QString());
+            continue;
+        }
 
-            if (!qmlplugindump.waitForFinished(3000) ||
-                qmlplugindump.exitCode() != 0) {
+        // The dump may have been written since the cache was looked up
+        {
+            QReadLocker modulePathsLock(&m_modulePathsLock);
+            const QString cachedFilePath = m_modulePaths.value(filePath);
+
+            if (!cachedFilePath.isEmpty()) {
+                result.append(cachedFilePath);
                 continue;
             }
+        }
+
+        // Create a dump of the file in the background, the requester is reparsed when it is ready
+        const bool isScheduled = m_pendingPluginDumps.contains(filePath);
+        QSet<KDevelop::IndexedString>& requesters = m_pendingPluginDumps[filePath];
+
+        if (!requester.isEmpty()) {
+            requesters.insert(requester);
+        }
+        if (!isScheduled) {
+            const QDateTime lastModified = fileInfo.lastModified();
+
+            QtConcurrent::run(&m_pluginDumpPool, [this, filePath, lastModified] {
+                dumpPlugin(filePath, lastModified);
+            });
+        }
+    }
+
+    return result;
+}
+
+void QmlJS::Cache::dumpPlugin(const QString& filePath, const QDateTime& lastModified)
+{
+    const QString dumpPath = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation)
+        + QLatin1Char('/') + pluginDumpFileName(filePath, lastModified);
+    const QStringList args = {QStringLiteral("-noinstantiate"), QStringLiteral("-path"), filePath};
+    QString result;
+
+    for (const PluginDumpExecutable& executable : m_pluginDumpExecutables) {
+        QProcess qmlplugindump;
+
+        qmlplugindump.setProcessChannelMode(QProcess::SeparateChannels);
+        qmlplugindump.setWorkingDirectory(QFileInfo(filePath).absolutePath());
+        qmlplugindump.start(executable.executable, args);
+
+        // Wait in steps, the dump is abandoned when the plugin is unloaded
+        QElapsedTimer timer;
+        timer.start();
+
+        bool finished = false;
+
+        while (qmlplugindump.state() != QProcess::NotRunning) {
+            if (qmlplugindump.waitForFinished(pluginDumpPollInterval)) {
+                finished = true;
+            } else if (m_stopPluginDumps.load() || timer.hasExpired(pluginDumpTimeout)) {
+                qmlplugindump.kill();
+                qmlplugindump.waitForFinished();
+            }
+        }
+
+        if (m_stopPluginDumps.load()) {
+            return;
+        }
 
-            // Open a file in which the dump can be written
-            QFile dumpFile(
-                QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation)
-                + dumpPath
-            );
+        if (!finished ||
+            qmlplugindump.exitStatus() != QProcess::NormalExit ||
+            qmlplugindump.exitCode() != 0) {
+            continue;
+        }
 
-            if (dumpFile.open(QIODevice::WriteOnly)) {
-                qmlplugindump.readLine();   // Skip "import QtQuick.tooling 1.1"
+        // Open a file in which the dump can be written
+        QDir().mkpath(QFileInfo(dumpPath).absolutePath());
+        QSaveFile dumpFile(dumpPath);
 
-                dumpFile.write("// " + filePath.toUtf8() + "\n");
-                dumpFile.write("import QtQuick " + executable.quickVersion.toUtf8() + "\n");
-                dumpFile.write(qmlplugindump.readAllStandardOutput());
-                dumpFile.close();
+        if (dumpFile.open(QIODevice::WriteOnly)) {
+            qmlplugindump.readLine();   // Skip "import QtQuick.tooling 1.1"
 
-                result.append(dumpFile.fileName());
+            dumpFile.write("// " + filePath.toUtf8() + "\n");
+            dumpFile.write("import QtQuick " + executable.quickVersion.toUtf8() + "\n");
+            dumpFile.write(qmlplugindump.readAllStandardOutput());
 
-                QMutexLocker lock(&m_mutex);
-                m_modulePaths.insert(filePath, dumpFile.fileName());
+            if (dumpFile.commit()) {
+                result = dumpPath;
                 break;
             }
         }
     }
 
-    return result;
+    QSet<KDevelop::IndexedString> requesters;
+    {
+        QMutexLocker lock(&m_mutex);
+
+        {
+            QWriteLocker modulePathsLock(&m_modulePathsLock);
+            m_modulePaths.insert(filePath, result);
+        }
+
+        requesters = m_pendingPluginDumps.take(filePath);
+
+        if (result.isEmpty()) {
+            qCDebug(KDEV_QMLJS_DUCHAIN) << "unable to dump" << filePath;
+            m_failedPluginDumps.insert(filePath, lastModified);
+            saveFailedPluginDumps();
+            return;
+        }
+    }
+
+    for (const KDevelop::IndexedString& file : requesters) {
+        ParseSession::scheduleForParsing(file, KDevelop::BackgroundParser::NormalPriority);
+    }
 }
 
-void QmlJS::Cache::setFileCustomIncludes(const KDevelop::IndexedString& file, const KDevelop::Path::List& dirs)
+void QmlJS::Cache::stopPluginDumps()
 {
+    m_stopPluginDumps.store(1);
+    m_pluginDumpPool.clear();
+    m_pluginDumpPool.waitForDone();
+
+    // The dumps that were cleared are started again when they are requested
     QMutexLocker lock(&m_mutex);
+    m_pendingPluginDumps.clear();
+    m_stopPluginDumps.store(0);
+}
+
+void QmlJS::Cache::loadFailedPluginDumps()
+{
+    QFile file(failedPluginDumpsFileName());
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    // Each line is "<modification time in ms since epoch> <path of the plugin>"
+    while (!file.atEnd()) {
+        const QString line = QString::fromUtf8(file.readLine()).trimmed();
+        const int separator = line.indexOf(QLatin1Char(' '));
+
+        if (separator > 0) {
+            m_failedPluginDumps.insert(line.mid(separator + 1),
+                                       QDateTime::fromMSecsSinceEpoch(line.left(separator).toLongLong()));
+        }
+    }
+}
+
+void QmlJS::Cache::saveFailedPluginDumps()
+{
+    const QString fileName = failedPluginDumpsFileName();
+
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QSaveFile file(fileName);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    for (auto it = m_failedPluginDumps.constBegin(); it != m_failedPluginDumps.constEnd(); ++it) {
+        file.write(QByteArray::number(it.value().toMSecsSinceEpoch()) + ' ' + it.key().toUtf8() + '\n');
+    }
+
+    file.commit();
+}
+
+void QmlJS::Cache::setFileCustomIncludes(const KDevelop::IndexedString& file, const KDevelop::Path::List& dirs)
+{
+    FileShard& fileShard = shard(file);
+    QWriteLocker lock(&fileShard.lock);
 
-    m_includeDirs[file] = dirs;
+    fileShard.includeDirs[file] = dirs;
 }
 
 void QmlJS::Cache::addDependency(const KDevelop::IndexedString& file, const KDevelop::IndexedString& dependency)
 {
-    QMutexLocker lock(&m_mutex);
+    // The two ends of the dependency may be in different shards, never lock both at once
+    {
+        FileShard& dependencyShard = shard(dependency);
+        QWriteLocker lock(&dependencyShard.lock);
+
+        dependencyShard.dependees[dependency].insert(file);
+    }
+    {
+        FileShard& fileShard = shard(file);
+        QWriteLocker lock(&fileShard.lock);
 
-    m_dependees[dependency].insert(file);
-    m_dependencies[file].insert(dependency);
+        fileShard.dependencies[file].insert(dependency);
+    }
 }
 
-QList<KDevelop::IndexedString> QmlJS::Cache::filesThatDependOn(const KDevelop::IndexedString& file)
+QSet<KDevelop::IndexedString> QmlJS::Cache::filesThatDependOn(const KDevelop::IndexedString& file)
 {
-    QMutexLocker lock(&m_mutex);
+    FileShard& fileShard = shard(file);
+    QReadLocker lock(&fileShard.lock);
 
-    return m_dependees[file].toList();
+    return fileShard.dependees.value(file);
 }
 
-QList<KDevelop::IndexedString> QmlJS::Cache::dependencies(const KDevelop::IndexedString& file)
+QSet<KDevelop::IndexedString> QmlJS::Cache::dependencies(const KDevelop::IndexedString& file)
 {
-    QMutexLocker lock(&m_mutex);
+    FileShard& fileShard = shard(file);
+    QReadLocker lock(&fileShard.lock);
 
-    return m_dependencies[file].toList();
+    return fileShard.dependencies.value(file);
 }
 
 bool QmlJS::Cache::isUpToDate(const KDevelop::IndexedString& file)
 {
-    QMutexLocker lock(&m_mutex);
+    FileShard& fileShard = shard(file);
+    QReadLocker lock(&fileShard.lock);
 
-    return m_isUpToDate.value(file, false);
+    return fileShard.isUpToDate.value(file, false);
 }
 
 void QmlJS::Cache::setUpToDate(const KDevelop::IndexedString& file, bool upToDate)
 {
-    QMutexLocker lock(&m_mutex);
+    FileShard& fileShard = shard(file);
+    QWriteLocker lock(&fileShard.lock);
+
+    fileShard.isUpToDate[file] = upToDate;
+}
+
+bool QmlJS::Cache::setExportedSignature(const KDevelop::IndexedString& file, uint signature)
+{
+    FileShard& fileShard = shard(file);
+    QWriteLocker lock(&fileShard.lock);
+
+    auto it = fileShard.exportedSignatures.find(file);
+
+    if (it != fileShard.exportedSignatures.end() && *it == signature) {
+        return false;
+    }
+
+    fileShard.exportedSignatures.insert(file, signature);
+    return true;
+}
+
+uint QmlJS::Cache::contentsHash(const KDevelop::IndexedString& file)
+{
+    FileShard& fileShard = shard(file);
+    QReadLocker lock(&fileShard.lock);
+
+    return fileShard.contentsHashes.value(file, 0);
+}
+
+void QmlJS::Cache::setContentsHash(const KDevelop::IndexedString& file, uint hash)
+{
+    FileShard& fileShard = shard(file);
+    QWriteLocker lock(&fileShard.lock);
+
+    fileShard.contentsHashes[file] = hash;
+}
+
+void QmlJS::Cache::removeFile(const KDevelop::IndexedString& file)
+{
+    QSet<KDevelop::IndexedString> dependencies;
+    {
+        FileShard& fileShard = shard(file);
+        QWriteLocker lock(&fileShard.lock);
+
+        dependencies = fileShard.dependencies.take(file);
+        fileShard.isUpToDate.remove(file);
+        fileShard.exportedSignatures.remove(file);
+        fileShard.contentsHashes.remove(file);
+        fileShard.includeDirs.remove(file);
+    }
+
+    // The files importing this one keep their dependency on it, they have to be
+    // updated if it comes back
+    for (const KDevelop::IndexedString& dependency : dependencies) {
+        FileShard& dependencyShard = shard(dependency);
+        QWriteLocker lock(&dependencyShard.lock);
+
+        auto dependees = dependencyShard.dependees.find(dependency);
+
+        if (dependees != dependencyShard.dependees.end()) {
+            dependees->remove(file);
 
-    m_isUpToDate[file] = upToDate;
+            if (dependees->isEmpty()) {
+                dependencyShard.dependees.erase(dependees);
+            }
+        }
+    }
 }
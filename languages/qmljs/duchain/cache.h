@@ -27,12 +27,16 @@
 #include <serialization/indexedstring.h>
 #include <util/path.h>
 
+#include <QAtomicInt>
 #include <QHash>
 #include <QStringList>
 #include <QFileInfo>
 #include <QList>
 #include <QSet>
 #include <QMutex>
+#include <QReadWriteLock>
+#include <QDateTime>
+#include <QThreadPool>
 
 namespace QmlJS
 {
@@ -68,9 +72,12 @@ public:
      * Return the list of the paths of the given files.
      *
      * Files having a name ending in ".so" are replaced with the path of their
-     * qmlplugindump dump.
+     * qmlplugindump dump. Plugins that have not been dumped yet are dumped in
+     * the background and left out of the result, @p requester is then reparsed
+     * once their dump is available.
      */
-    QStringList getFileNames(const QFileInfoList& fileInfos);
+    QStringList getFileNames(const QFileInfoList& fileInfos,
+                             const KDevelop::IndexedString& requester = KDevelop::IndexedString());
 
     /**
      * Set the custom include directories list of a file
@@ -84,14 +91,14 @@ public:
     void addDependency(const KDevelop::IndexedString& file, const KDevelop::IndexedString& dependency);
 
     /**
-     * List of the files that depend on a given URL
+     * Set of the files that depend on a given URL
      */
-    QList<KDevelop::IndexedString> filesThatDependOn(const KDevelop::IndexedString& file);
+    QSet<KDevelop::IndexedString> filesThatDependOn(const KDevelop::IndexedString& file);
 
     /**
-     * List of the dependencies of a file
+     * Set of the dependencies of a file
      */
-    QList<KDevelop::IndexedString> dependencies(const KDevelop::IndexedString& file);
+    QSet<KDevelop::IndexedString> dependencies(const KDevelop::IndexedString& file);
 
     /**
      * Return whether a file is up to date (all its dependencies are up to date
@@ -100,6 +107,30 @@ public:
     bool isUpToDate(const KDevelop::IndexedString& file);
     void setUpToDate(const KDevelop::IndexedString& file, bool upToDate);
 
+    /**
+     * Store the signature of the declarations exported by @p file, and return
+     * whether it differs from the one stored when the file was last parsed
+     */
+    bool setExportedSignature(const KDevelop::IndexedString& file, uint signature);
+
+    /**
+     * Hash of the contents from which @p file was last built, or 0 if unknown
+     */
+    uint contentsHash(const KDevelop::IndexedString& file);
+    void setContentsHash(const KDevelop::IndexedString& file, uint hash);
+
+    /**
+     * Forget everything known about @p file, for instance because it is not
+     * part of a project anymore
+     */
+    void removeFile(const KDevelop::IndexedString& file);
+
+    /**
+     * Cancel the plugin dumps which did not start yet, kill the running ones
+     * and wait for them. Called when the plugin is unloaded.
+     */
+    void stopPluginDumps();
+
 private:
     struct PluginDumpExecutable {
         QString executable;
@@ -110,13 +141,48 @@ private:
         {}
     };
 
-    QMutex m_mutex;
+    /**
+     * Run qmlplugindump on @p filePath and reparse the files waiting for the
+     * dump. Called in m_pluginDumpPool.
+     */
+    void dumpPlugin(const QString& filePath, const QDateTime& lastModified);
+
+    /**
+     * Plugins that qmlplugindump could not dump are remembered across sessions,
+     * so that they are not dumped again until they change.
+     */
+    void loadFailedPluginDumps();
+    void saveFailedPluginDumps();
+
+    /**
+     * What is known about the files whose URL hashes to the same shard. The
+     * files are spread over several shards so that parse threads working on
+     * different files don't wait for each other, and can read concurrently.
+     */
+    struct FileShard {
+        QReadWriteLock lock;
+        QHash<KDevelop::IndexedString, QSet<KDevelop::IndexedString>> dependees;
+        QHash<KDevelop::IndexedString, QSet<KDevelop::IndexedString>> dependencies;
+        QHash<KDevelop::IndexedString, bool> isUpToDate;
+        QHash<KDevelop::IndexedString, uint> exportedSignatures;
+        QHash<KDevelop::IndexedString, uint> contentsHashes;
+        QHash<KDevelop::IndexedString, KDevelop::Path::List> includeDirs;
+    };
+
+    FileShard& shard(const KDevelop::IndexedString& file);
+
+    static const int ShardCount = 16;
+    FileShard m_shards[ShardCount];
+
+    QReadWriteLock m_modulePathsLock;
     QHash<QString, QString> m_modulePaths;
+
+    QMutex m_mutex;     // Protects the state of the plugin dumps, locked before m_modulePathsLock
     QList<PluginDumpExecutable> m_pluginDumpExecutables;
-    QHash<KDevelop::IndexedString, QSet<KDevelop::IndexedString>> m_dependees;
-    QHash<KDevelop::IndexedString, QSet<KDevelop::IndexedString>> m_dependencies;
-    QHash<KDevelop::IndexedString, bool> m_isUpToDate;
-    QHash<KDevelop::IndexedString, KDevelop::Path::List> m_includeDirs;
+    QThreadPool m_pluginDumpPool;
+    QAtomicInt m_stopPluginDumps;
+    QHash<QString, QSet<KDevelop::IndexedString>> m_pendingPluginDumps;    // Plugin -> files to reparse once it is dumped
+    QHash<QString, QDateTime> m_failedPluginDumps;                          // Plugin -> its modification time when dumping it failed
 };
 
 }
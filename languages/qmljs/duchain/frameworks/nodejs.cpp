@@ -33,9 +33,16 @@
 #include <QFile>
 #include <QDir>
 #include <QStandardPaths>
+#include <QJsonDocument>
+#include <QJsonObject>
 
 using namespace KDevelop;
 
+namespace {
+// Interval in ms after which the index of a modules directory is compared to the directory again
+const qint64 indexCheckInterval = 2000;
+}
+
 namespace QmlJS {
 
 NodeJS::NodeJS()
@@ -142,18 +149,23 @@ DeclarationPointer NodeJS::moduleMember(const QString& moduleName,
 
 Path::List NodeJS::moduleDirectories(const QString& url)
 {
-    Path::List paths;
-
     // QML/JS ships several modules that exist only in binary form in Node.js
-    QStringList dirs = QStandardPaths::locateAll(
-        QStandardPaths::GenericDataLocation,
-        QStringLiteral("kdevqmljssupport/nodejsmodules"),
-        QStandardPaths::LocateDirectory
-    );
-
-    for (auto dir : dirs) {
-        paths.append(Path(dir));
-    }
+    static const Path::List builtinPaths = [] {
+        Path::List paths;
+        const QStringList dirs = QStandardPaths::locateAll(
+            QStandardPaths::GenericDataLocation,
+            QStringLiteral("kdevqmljssupport/nodejsmodules"),
+            QStandardPaths::LocateDirectory
+        );
+
+        for (auto dir : dirs) {
+            paths.append(Path(dir));
+        }
+
+        return paths;
+    }();
+
+    Path::List paths = builtinPaths;
 
     // url/../node_modules, then url/../../node_modules, etc
     Path path(url);
@@ -170,43 +182,136 @@ Path::List NodeJS::moduleDirectories(const QString& url)
 QString NodeJS::moduleFileName(const QString& moduleName, const QString& url)
 {
     QMutexLocker lock(&m_mutex);
-    auto pair = qMakePair(moduleName, url);
-
-    if (m_cachedModuleFileNames.contains(pair)) {
-        return m_cachedModuleFileNames.value(pair);
-    }
-
-    QString& fileName = m_cachedModuleFileNames[pair];
 
     // Absolue and relative URLs
     if (moduleName.startsWith(QLatin1Char('/')) || moduleName.startsWith(QLatin1Char('.'))) {
+        auto pair = qMakePair(moduleName, url);
+
+        if (m_cachedModuleFileNames.contains(pair)) {
+            return m_cachedModuleFileNames.value(pair);
+        }
+
         // NOTE: This is not portable to Windows, but the Node.js documentation
         // only talks about module names that start with /, ./ and ../ .
-        fileName = fileOrDirectoryPath(Path(url).cd(QStringLiteral("..")).cd(moduleName).toLocalFile());
+        QString fileName = fileOrDirectoryPath(Path(url).cd(QStringLiteral("..")).cd(moduleName).toLocalFile());
+
+        m_cachedModuleFileNames.insert(pair, fileName);
         return fileName;
     }
 
-    // Try all the paths that might contain modules
+    // Try all the paths that might contain modules. Module names like "foo/bar"
+    // or "@scope/foo" are not indexed and looked up in the file system.
+    const bool isIndexed = !moduleName.contains(QLatin1Char('/'));
+
     for (auto path : moduleDirectories(url)) {
-        fileName = fileOrDirectoryPath(path.cd(moduleName).toLocalFile());
+        QString fileName = isIndexed ?
+            indexedModuleFileName(path.toLocalFile(), moduleName) :
+            fileOrDirectoryPath(path.cd(moduleName).toLocalFile());
 
         if (!fileName.isNull()) {
-            break;
+            return fileName;
+        }
+    }
+
+    return QString();
+}
+
+QString NodeJS::indexedModuleFileName(const QString& directory, const QString& moduleName)
+{
+    // Listing the directory once is cheaper than probing it for every require().
+    // Directories that don't exist have an invalid modification time, and an
+    // empty index is kept for them. Modules are looked up very often (the
+    // builtin ones for most expressions), so changes are only checked for
+    // from time to time.
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    ModuleDirectoryIndex& index = m_moduleDirectories[directory];
+
+    if (now - index.checkedAt > indexCheckInterval) {
+        const QDateTime lastModified = QFileInfo(directory).lastModified();
+
+        if (index.lastModified != lastModified) {
+            index = ModuleDirectoryIndex();
+            index.lastModified = lastModified;
+
+            for (const QFileInfo& entry : QDir(directory).entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot)) {
+                if (entry.isDir()) {
+                    index.directories.insert(entry.fileName());
+                } else {
+                    index.files.insert(entry.fileName());
+                }
+            }
+        }
+
+        index.checkedAt = now;
+    }
+
+    const QString baseName = directory + QLatin1Char('/') + moduleName;
+
+    if (index.files.contains(moduleName)) {
+        return baseName;
+    } else if (index.files.contains(moduleName + QLatin1String(".js"))) {
+        return baseName + QLatin1String(".js");
+    } else if (index.directories.contains(moduleName)) {
+        // Editing package.json does not change the modules directory
+        Package& package = index.packages[moduleName];
+
+        if (now - package.checkedAt > indexCheckInterval) {
+            const QDateTime lastModified = QFileInfo(baseName + QLatin1String("/package.json")).lastModified();
+
+            if (package.checkedAt == 0 || package.lastModified != lastModified) {
+                package.fileName = packageFileName(baseName);
+                package.lastModified = lastModified;
+            }
+
+            package.checkedAt = now;
         }
+
+        return package.fileName;
     }
 
-    return fileName;
+    return QString();
 }
 
 QString NodeJS::fileOrDirectoryPath(const QString& baseName)
 {
-    if (QFile::exists(baseName)) {
+    QFileInfo info(baseName);
+
+    if (info.isFile()) {
         return baseName;
     } else if (QFile::exists(baseName + QLatin1String(".js"))) {
         return baseName + QLatin1String(".js");
-    } else if (QFile::exists(baseName + QLatin1String("/index.js"))) {
-        // TODO: package.json files currently not supported
-        return baseName + QLatin1String("/index.js");
+    } else if (info.isDir()) {
+        return packageFileName(baseName);
+    }
+
+    return QString();
+}
+
+QString NodeJS::packageFileName(const QString& directory)
+{
+    // The "main" entry of package.json names the main file of the package
+    QFile packageFile(directory + QLatin1String("/package.json"));
+
+    if (packageFile.open(QIODevice::ReadOnly)) {
+        const QString main = QJsonDocument::fromJson(packageFile.readAll()).object()
+            .value(QStringLiteral("main")).toString();
+        const QString mainPath = QDir::cleanPath(directory + QLatin1Char('/') + main);
+
+        if (!main.isEmpty() && mainPath != QDir::cleanPath(directory)) {
+            QFileInfo info(mainPath);
+
+            if (info.isFile()) {
+                return mainPath;
+            } else if (QFile::exists(mainPath + QLatin1String(".js"))) {
+                return mainPath + QLatin1String(".js");
+            } else if (QFile::exists(mainPath + QLatin1String("/index.js"))) {
+                return mainPath + QLatin1String("/index.js");
+            }
+        }
+    }
+
+    if (QFile::exists(directory + QLatin1String("/index.js"))) {
+        return directory + QLatin1String("/index.js");
     }
 
     return QString();
@@ -27,7 +27,9 @@
 #include <language/duchain/duchainpointer.h>
 #include <util/path.h>
 
+#include <QDateTime>
 #include <QMutex>
+#include <QSet>
 
 namespace QmlJS {
 
@@ -75,10 +77,32 @@ private:
     void createObject(const QString& name, int index, DeclarationBuilder* builder);
     QString moduleFileName(const QString& moduleName, const QString& url);
     QString fileOrDirectoryPath(const QString& baseName);
+    QString packageFileName(const QString& directory);
+
+    /**
+     * File of the module @p moduleName in the modules directory @p directory,
+     * looked up in an index of the directory instead of the file system
+     */
+    QString indexedModuleFileName(const QString& directory, const QString& moduleName);
 
 private:
+    struct Package {
+        QString fileName;                   // The main file of the package
+        QDateTime lastModified;             // The main file is resolved again when package.json changes
+        qint64 checkedAt = 0;               // When lastModified was last compared to package.json
+    };
+
+    struct ModuleDirectoryIndex {
+        QDateTime lastModified;             // The index is rebuilt when the directory changes
+        qint64 checkedAt = 0;               // When lastModified was last compared to the directory
+        QSet<QString> files;
+        QSet<QString> directories;
+        QHash<QString, Package> packages;   // Directory -> its package, resolved when first used
+    };
+
     typedef QHash<QPair<QString, QString>, QString> CachedModuleFileNamesHash;
     CachedModuleFileNamesHash m_cachedModuleFileNames;
+    QHash<QString, ModuleDirectoryIndex> m_moduleDirectories;
     QMutex m_mutex;
 };
 
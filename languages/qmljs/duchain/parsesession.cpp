@@ -27,6 +27,7 @@
 #include <language/duchain/duchain.h>
 #include <language/duchain/duchainlock.h>
 #include <language/duchain/declaration.h>
+#include <language/duchain/parsingenvironment.h>
 #include <language/backgroundparser/backgroundparser.h>
 #include <interfaces/ilanguagecontroller.h>
 #include <interfaces/icore.h>
@@ -39,6 +40,16 @@ IndexedString ParseSession::languageString()
     return langString;
 }
 
+/**
+ * Whether @p fileName describes a module instead of being part of a project:
+ * a plugins.qmltypes file, a qmlplugindump dump or a module shipped with kdev-qmljs
+ */
+static bool isModuleFile(const QString& fileName)
+{
+    return fileName.endsWith(QLatin1String(".qmltypes")) ||
+           fileName.contains(QLatin1String("/kdevqmljssupport/"));
+}
+
 bool isSorted(const QList<QmlJS::AST::SourceLocation>& locations)
 {
     if (locations.size() <= 1) {
@@ -241,6 +252,13 @@ ReferencedTopDUContext ParseSession::contextOfFile(const QString& fileName,
     DUChainReadLocker lock;
     IndexedString moduleFileString(fileName);
     ReferencedTopDUContext moduleContext = DUChain::self()->chainForDocument(moduleFileString);
+    bool isOutdatedModule = false;
+    const bool isModule = moduleContext && isModuleFile(fileName);
+
+    if (isModule) {
+        ParsingEnvironmentFilePointer file = moduleContext->parsingEnvironmentFile();
+        isOutdatedModule = !file || file->needsUpdate();
+    }
 
     lock.unlock();
     QmlJS::Cache::instance().addDependency(url, moduleFileString);
@@ -251,20 +269,35 @@ ReferencedTopDUContext ParseSession::contextOfFile(const QString& fileName,
 
         // Register a dependency between this file and the imported one
         return ReferencedTopDUContext();
-    } else {
-        return moduleContext;
     }
+
+    if (isOutdatedModule) {
+        // The module changed (Qt was updated for instance), use it until it is parsed again
+        scheduleForParsing(moduleFileString, ownPriority - 1);
+    } else if (isModule && !QmlJS::Cache::instance().isUpToDate(moduleFileString)) {
+        // Modules are stored in the DUChain across sessions, and don't have to be
+        // parsed again before their importers can be updated
+        QmlJS::Cache::instance().setUpToDate(moduleFileString, true);
+    }
+
+    return moduleContext;
 }
 
-void ParseSession::reparseImporters()
+void ParseSession::reparseImporters(bool exportsChanged)
 {
     for (const KDevelop::IndexedString& file : QmlJS::Cache::instance().filesThatDependOn(m_url)) {
-        scheduleForParsing(file, m_ownPriority);
+        if (exportsChanged || !QmlJS::Cache::instance().isUpToDate(file)) {
+            scheduleForParsing(file, m_ownPriority);
+        }
     }
 }
 
 void ParseSession::scheduleForParsing(const IndexedString& url, int priority)
 {
+    if (!KDevelop::ICore::self() || KDevelop::ICore::self()->shuttingDown()) {
+        return;
+    }
+
     BackgroundParser* bgparser = KDevelop::ICore::self()->languageController()->backgroundParser();
     TopDUContext::Features features = (TopDUContext::Features)
         (TopDUContext::ForceUpdate | TopDUContext::AllDeclarationsContextsAndUses);
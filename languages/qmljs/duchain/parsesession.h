@@ -158,9 +158,11 @@ public:
                                                           int ownPriority);
 
     /**
-     * Schedule for update all the files that depend on this file
+     * Schedule for update the files that depend on this file. If the declarations
+     * exported by this file did not change, only the importers that are waiting
+     * for it are scheduled, the others are still up to date.
      */
-    void reparseImporters();
+    void reparseImporters(bool exportsChanged = true);
 
     /**
      * Schedule a document for update using the default flags of QML/JS
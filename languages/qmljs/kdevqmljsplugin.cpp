@@ -25,6 +25,7 @@
 #include "codecompletion/model.h"
 #include "navigation/propertypreviewwidget.h"
 #include "duchain/helper.h"
+#include "duchain/cache.h"
 
 #include <qmljs/qmljsmodelmanagerinterface.h>
 
@@ -41,9 +42,12 @@
 #include <interfaces/icore.h>
 #include <interfaces/idocumentcontroller.h>
 #include <interfaces/ilanguagecontroller.h>
+#include <interfaces/iprojectcontroller.h>
 #include <interfaces/contextmenuextension.h>
+#include <project/projectmodel.h>
 
 #include <QReadWriteLock>
+#include <QSet>
 
 K_PLUGIN_FACTORY_WITH_JSON(KDevQmlJsSupportFactory, "kdevqmljs.json", registerPlugin<KDevQmlJsPlugin>(); )
 
@@ -78,10 +82,17 @@ KDevQmlJsPlugin::KDevQmlJsPlugin(QObject* parent, const QVariantList& )
 
     auto assistantsManager = core()->languageController()->staticAssistantsManager();
     assistantsManager->registerAssistant(StaticAssistant::Ptr(new RenameAssistant(this)));
+
+    // Forget about the files leaving the projects, including the files of closed projects
+    connect(core()->projectController()->projectModel(), &ProjectModel::rowsAboutToBeRemoved,
+            this, &KDevQmlJsPlugin::projectRowsAboutToBeRemoved);
 }
 
 KDevQmlJsPlugin::~KDevQmlJsPlugin()
 {
+    // The cache outlives the plugin, its dumps must not reparse anything anymore
+    QmlJS::Cache::instance().stopPluginDumps();
+
     parseLock()->lockForWrite();
     // By locking the parse-mutexes, we make sure that parse jobs get a chance to finish in a good state
     parseLock()->unlock();
@@ -89,6 +100,62 @@ KDevQmlJsPlugin::~KDevQmlJsPlugin()
     QmlJS::unregisterDUChainItems();
 }
 
+static void collectFiles(ProjectBaseItem* item, QSet<IndexedString>& files)
+{
+    if (item->file()) {
+        files.insert(item->indexedPath());
+    }
+
+    foreach (ProjectBaseItem* child, item->children()) {
+        collectFiles(child, files);
+    }
+}
+
+static bool isBelow(ProjectBaseItem* item, const QList<ProjectBaseItem*>& roots)
+{
+    for (; item; item = item->parent()) {
+        if (roots.contains(item)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void KDevQmlJsPlugin::projectRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last)
+{
+    ProjectModel* model = core()->projectController()->projectModel();
+    QList<ProjectBaseItem*> removed;
+    QSet<IndexedString> files;
+
+    for (int row = first; row <= last; ++row) {
+        if (ProjectBaseItem* item = model->itemFromIndex(model->index(row, 0, parent))) {
+            removed << item;
+            collectFiles(item, files);
+        }
+    }
+
+    // Items are also removed when a project is reloaded or when the targets of
+    // a build system are refreshed, only forget the files that are really gone:
+    // forgetting a file marks it as not up to date, which blocks its importers
+    // until it is parsed again.
+    foreach (const IndexedString& file, files) {
+        bool keep = core()->documentController()->documentForUrl(file.toUrl()) != nullptr;
+
+        foreach (ProjectBaseItem* item, model->itemsForPath(file)) {
+            keep = keep || !isBelow(item, removed);
+        }
+
+        foreach (const IndexedString& importer, QmlJS::Cache::instance().filesThatDependOn(file)) {
+            keep = keep || !files.contains(importer);
+        }
+
+        if (!keep) {
+            QmlJS::Cache::instance().removeFile(file);
+        }
+    }
+}
+
 ParseJob* KDevQmlJsPlugin::createParseJob(const IndexedString& url)
 {
     return new QmlJsParseJob(url, this);
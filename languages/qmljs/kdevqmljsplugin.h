@@ -24,6 +24,7 @@
 #include <language/interfaces/ilanguagesupport.h>
 
 class ModelManager;
+class QModelIndex;
 
 class KDevQmlJsPlugin : public KDevelop::IPlugin, public KDevelop::ILanguageSupport
 {
@@ -42,6 +43,9 @@ public:
     KDevelop::ContextMenuExtension contextMenuExtension(KDevelop::Context* context) override;
     QWidget* specialLanguageObjectNavigationWidget(const QUrl& url, const KTextEditor::Cursor& position) override;
 
+private slots:
+    void projectRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last);
+
 private:
     KDevelop::ICodeHighlighting* m_highlighting;
     KDevelop::BasicRefactoring* m_refactoring;
@@ -26,6 +26,8 @@
 #include <language/duchain/duchainutils.h>
 #include <language/duchain/duchain.h>
 #include <language/duchain/parsingenvironment.h>
+#include <language/duchain/declaration.h>
+#include <language/util/kdevhash.h>
 #include <interfaces/icore.h>
 #include <interfaces/iprojectcontroller.h>
 #include <interfaces/iproject.h>
@@ -75,6 +77,31 @@ ProjectFileItem* findProjectFileItem(const IndexedString& url)
     return file;
 }
 
+/**
+ * Hash of the declarations that @p context exports to the files importing it:
+ * their identifiers, kinds and types, and the declarations nested in them (the
+ * members of components and the values of enums), but not the bodies of functions.
+ */
+static uint exportedSignature(const DUContext* context)
+{
+    KDevHash hash;
+
+    for (const Declaration* declaration : context->localDeclarations()) {
+        hash << declaration->indexedIdentifier().getIndex()
+             << declaration->kind()
+             << (declaration->abstractType() ? declaration->abstractType()->hash() : 0);
+
+        const DUContext* internal = declaration->internalContext();
+        if (internal && internal != context &&
+            (internal->type() == DUContext::Class || internal->type() == DUContext::Namespace ||
+             internal->type() == DUContext::Enum)) {
+            hash << exportedSignature(internal);
+        }
+    }
+
+    return hash;
+}
+
 QmlJsParseJob::QmlJsParseJob(const IndexedString& url, ILanguageSupport* languageSupport)
 : ParseJob(url, languageSupport)
 {
@@ -118,12 +145,6 @@ void QmlJsParseJob::run(ThreadWeaver::JobPointer pointer, ThreadWeaver::Thread*
         return;
     }
 
-    ParseSession session(document(), contents().contents, priority());
-
-    if (abortRequested()) {
-        return;
-    }
-
     ReferencedTopDUContext context;
     {
         DUChainReadLocker lock;
@@ -134,6 +155,33 @@ void QmlJsParseJob::run(ThreadWeaver::JobPointer pointer, ThreadWeaver::Thread*
         context->setRange(RangeInRevision(0, 0, INT_MAX, INT_MAX));
     }
 
+    // Saving a document or undoing an edit changes its revision but not its contents,
+    // the DUChain built from the same contents only has to be moved to the new revision
+    const uint contentsHash = qHash(contents().contents);
+
+    if (context && !(minimumFeatures() & TopDUContext::ForceUpdate) &&
+        QmlJS::Cache::instance().isUpToDate(document()) &&
+        QmlJS::Cache::instance().contentsHash(document()) == contentsHash) {
+        DUChainWriteLocker lock;
+
+        if ((context->features() & minimumFeatures()) == minimumFeatures()) {
+            qCDebug(KDEV_QMLJS) << "contents unchanged, not rebuilding" << document().str();
+
+            ParsingEnvironmentFilePointer file = context->parsingEnvironmentFile();
+            Q_ASSERT(file);
+            file->setModificationRevision(contents().modification);
+            DUChain::self()->updateContextEnvironment(context->topContext(), file.data());
+            setDuChain(context);
+            return;
+        }
+    }
+
+    ParseSession session(document(), contents().contents, priority());
+
+    if (abortRequested()) {
+        return;
+    }
+
     if (session.ast()) {
         QReadLocker parseLock(languageSupport()->parseLock());
 
@@ -175,9 +223,18 @@ void QmlJsParseJob::run(ThreadWeaver::JobPointer pointer, ThreadWeaver::Thread*
     QmlJS::Cache::instance().setUpToDate(document(), dependenciesOk);
 
     if (dependenciesOk) {
-        session.reparseImporters();
+        uint signature;
+        {
+            DUChainReadLocker lock;
+            signature = exportedSignature(context);
+        }
+
+        // Importers that are up to date only need an update when what they use changed
+        session.reparseImporters(QmlJS::Cache::instance().setExportedSignature(document(), signature));
     }
 
+    QmlJS::Cache::instance().setContentsHash(document(), dependenciesOk ? contentsHash : 0);
+
     {
         DUChainWriteLocker lock;
         context->setProblems(session.problems());
@@ -0,0 +1,81 @@
+/*************************************************************************************
+ *  This program is free software; you can redistribute it and/or                    *
+ *  modify it under the terms of the GNU General Public License                      *
+ *  as published by the Free Software Foundation; either version 2                   *
+ *  of the License, or (at your option) any later version.                           *
+ *                                                                                   *
+ *  This program is distributed in the hope that it will be useful,                  *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of                   *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                    *
+ *  GNU General Public License for more details.                                     *
+ *                                                                                   *
+ *  You should have received a copy of the GNU General Public License                *
+ *  along with this program; if not, write to the Free Software                      *
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA   *
+ *************************************************************************************/
+
+#include "bench_parser.h"
+
+#include <tests/testcore.h>
+#include <tests/autotestshell.h>
+
+#include "../duchain/parsesession.h"
+#include "testfilepaths.h"
+
+#include <QDir>
+#include <QtTest>
+
+using namespace KDevelop;
+
+QTEST_MAIN(BenchParser)
+
+/**
+ * Contents of the files matching @p nameFilters in @p directory, keyed by their path
+ */
+static QHash<QString, QString> readFiles(const QString& directory, const QStringList& nameFilters)
+{
+    QHash<QString, QString> files;
+
+    for (const QFileInfo& info : QDir(directory).entryInfoList(nameFilters, QDir::Files)) {
+        QFile file(info.filePath());
+
+        if (file.open(QIODevice::ReadOnly)) {
+            files.insert(info.filePath(), QString::fromUtf8(file.readAll()));
+        }
+    }
+
+    return files;
+}
+
+void BenchParser::initTestCase()
+{
+    AutoTestShell::init({"kdevqmljslanguagesupport"});
+    TestCore::initialize(KDevelop::Core::NoUi);
+}
+
+void BenchParser::cleanupTestCase()
+{
+    TestCore::shutdown();
+}
+
+void BenchParser::benchParse_data()
+{
+    QTest::addColumn<QHash<QString, QString>>("files");
+
+    // The modules shipped with kdev-qmljs contain the big generated DOM and ECMAScript APIs
+    QTest::newRow("nodejs modules") << readFiles(NODEJS_MODULES_DIR, {QStringLiteral("*.js")});
+    QTest::newRow("test files") << readFiles(TEST_FILES_DIR, {QStringLiteral("*.js"), QStringLiteral("*.qml")});
+}
+
+void BenchParser::benchParse()
+{
+    QFETCH(QHash<QString, QString>, files);
+    QVERIFY(!files.isEmpty());
+
+    // Many files are parsed one after the other, as when opening a project
+    QBENCHMARK {
+        for (auto it = files.constBegin(); it != files.constEnd(); ++it) {
+            ParseSession session(IndexedString(it.key()), it.value(), 0);
+        }
+    }
+}
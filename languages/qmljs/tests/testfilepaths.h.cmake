@@ -1,2 +1,3 @@
 #define TEST_FILES_DIR "${CMAKE_CURRENT_SOURCE_DIR}/files"
 
+#define NODEJS_MODULES_DIR "${CMAKE_CURRENT_SOURCE_DIR}/../nodejsmodules"
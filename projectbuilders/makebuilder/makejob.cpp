@@ -24,7 +24,6 @@
 #include "makejob.h"
 
 #include <QFileInfo>
-#include <QRegularExpression>
 #include <QThread>
 #include <QFileInfo>
 
@@ -57,20 +56,30 @@ public:
 IFilterStrategy::Progress MakeJobCompilerFilterStrategy::progressInLine(const QString& line)
 {
     // example string: [ 97%] Built target clang-parser
-    static const QRegularExpression re("^\\[([\\d ][\\d ]\\d)%\\] (.*)");
-
-    QRegularExpressionMatch match = re.match(line);
-    if (match.hasMatch()) {
-        bool ok;
-        const int percent = match.capturedRef(1).toInt(&ok);
-        if (ok) {
-            // this is output from make, likely
-            const QString action = match.captured(2);
-            return {action, percent};
+    // this is called for every line of output, so check the fixed format by hand
+    if (line.size() < 7 || line.at(0) != QLatin1Char('[') || line.at(4) != QLatin1Char('%')
+        || line.at(5) != QLatin1Char(']') || line.at(6) != QLatin1Char(' '))
+    {
+        return {};
+    }
+
+    // the percentage is right-aligned: leading blanks, then at least one digit
+    int percent = -1;
+    for (int i = 1; i < 4; ++i) {
+        const ushort c = line.at(i).unicode();
+        if (c >= '0' && c <= '9') {
+            percent = qMax(percent, 0) * 10 + (c - '0');
+        } else if (c != ' ' || percent != -1) {
+            return {};
         }
     }
+    if (percent == -1) {
+        return {};
+    }
 
-    return {};
+    // this is output from make, likely
+    const QString action = line.mid(7);
+    return {action, percent};
 }
 
 MakeJob::MakeJob(QObject* parent, KDevelop::ProjectBaseItem* item,
@@ -0,0 +1,57 @@
+/* This file is part of KDevelop
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+
+#ifndef ININJABUILDER_H
+#define ININJABUILDER_H
+
+#include <project/interfaces/iprojectbuilder.h>
+#include <util/path.h>
+
+#include <QStringList>
+
+/**
+ * Answers questions about a ninja build directory from what ninja recorded
+ * during previous builds. All queries return nothing before the first build.
+ * What ninja recorded is read in the background, until that is done the
+ * queries answer from the previous builds.
+ */
+class INinjaBuilder : public KDevelop::IProjectBuilder
+{
+public:
+    virtual ~INinjaBuilder() {}
+
+    /**
+     * @return the ninja outputs built from @p file, e.g. its object file. For a header
+     *         these are the outputs of all translation units including it.
+     */
+    virtual QStringList outputsForFile(KDevelop::ProjectBaseItem* item, const KDevelop::Path& file) = 0;
+
+    /**
+     * @return the sources of all translation units that depend on @p file, e.g. the
+     *         .cpp files including a header
+     */
+    virtual KDevelop::Path::List sourcesDependingOn(KDevelop::ProjectBaseItem* item, const KDevelop::Path& file) = 0;
+
+    /**
+     * @return how long building @p outputs took the last time in ms, or -1 if unknown
+     */
+    virtual int lastBuildDuration(KDevelop::ProjectBaseItem* item, const QStringList& outputs) = 0;
+};
+
+Q_DECLARE_INTERFACE( INinjaBuilder, "org.kdevelop.INinjaBuilder" )
+
+#endif
@@ -19,6 +19,8 @@
 
 #include "ninjabuilder.h"
 
+#include "debug.h"
+
 #include "ninjajob.h"
 #include "ninjabuilderpreferences.h"
 
@@ -32,11 +34,8 @@
 #include <interfaces/iproject.h>
 
 #include <QFile>
-#include <QLoggingCategory>
-
-Q_DECLARE_LOGGING_CATEGORY(NINJABUILDER)
+#include <QtConcurrentRun>
 
-Q_LOGGING_CATEGORY(NINJABUILDER, "kdevelop.projectbuilders.ninjabuilder")
 K_PLUGIN_FACTORY_WITH_JSON(NinjaBuilderFactory, "kdevninja.json", registerPlugin<NinjaBuilder>(); )
 
 NinjaBuilder::NinjaBuilder(QObject* parent, const QVariantList&)
@@ -47,6 +46,14 @@ NinjaBuilder::NinjaBuilder(QObject* parent, const QVariantList&)
     }
 }
 
+NinjaBuilder::~NinjaBuilder()
+{
+    // the updates must not outlive the plugin's code
+    foreach (auto watcher, m_buildGraphUpdates) {
+        watcher->waitForFinished();
+    }
+}
+
 static QStringList targetsInFolder(KDevelop::ProjectFolderItem* item)
 {
     QStringList ret;
@@ -138,11 +145,24 @@ NinjaJob* NinjaBuilder::runNinja(KDevelop::ProjectBaseItem* item, NinjaJob::Comm
 
     NinjaJob* job = new NinjaJob(item, commandType, jobArguments, signal, this);
     m_activeNinjaJobs.append(job);
+
+    // have what the build recorded ready for the next request
+    const KDevelop::Path directory = NinjaJob::ninjaDirectory(item);
+    connect(job, &KJob::finished, this, [this, directory]() {
+        updateBuildGraph(directory);
+    });
     return job;
 }
 
 KJob* NinjaBuilder::build(KDevelop::ProjectBaseItem* item)
 {
+    if (item->type() == KDevelop::ProjectBaseItem::File) {
+        // prefer the exact outputs over "file^", which only works for sources known to build.ninja
+        const QStringList outputs = outputsForFile(item, item->path());
+        if (!outputs.isEmpty()) {
+            return runNinja(item, NinjaJob::BuildCommand, outputs, "built");
+        }
+    }
     return runNinja(item, NinjaJob::BuildCommand, argumentsForItem(item), "built");
 }
 
@@ -183,6 +203,76 @@ KDevelop::ConfigPage* NinjaBuilder::perProjectConfigPage(int number, const KDeve
     return nullptr;
 }
 
+const NinjaBuildGraph& NinjaBuilder::buildGraph(KDevelop::ProjectBaseItem* item)
+{
+    const KDevelop::Path directory = NinjaJob::ninjaDirectory(item);
+    auto it = m_buildGraphs.find(directory);
+    if (it == m_buildGraphs.end()) {
+        it = m_buildGraphs.insert(directory, NinjaBuildGraph(directory.toLocalFile()));
+    }
+    updateBuildGraph(directory);
+    return *it;
+}
+
+static NinjaBuildGraph updatedBuildGraph(NinjaBuildGraph graph)
+{
+    graph.update();
+    return graph;
+}
+
+void NinjaBuilder::updateBuildGraph(const KDevelop::Path& directory)
+{
+    if (m_buildGraphUpdates.contains(directory)) {
+        return;
+    }
+
+    const NinjaBuildGraph graph = m_buildGraphs.value(directory, NinjaBuildGraph(directory.toLocalFile()));
+    if (!graph.isOutdated()) {
+        return;
+    }
+
+    // the files of big projects have tens of MB, don't read them in the GUI thread
+    auto watcher = new QFutureWatcher<NinjaBuildGraph>(this);
+    m_buildGraphUpdates.insert(directory, watcher);
+    connect(watcher, &QFutureWatcher<NinjaBuildGraph>::finished, this, [this, watcher, directory]() {
+        m_buildGraphs.insert(directory, watcher->result());
+        m_buildGraphUpdates.remove(directory);
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run(updatedBuildGraph, graph));
+}
+
+QStringList NinjaBuilder::outputsForFile(KDevelop::ProjectBaseItem* item, const KDevelop::Path& file)
+{
+    const NinjaBuildGraph& graph = buildGraph(item);
+    const QString path = file.toLocalFile();
+    const QStringList outputs = graph.outputsForSource(path);
+    return outputs.isEmpty() ? graph.outputsDependingOn(path) : outputs;
+}
+
+KDevelop::Path::List NinjaBuilder::sourcesDependingOn(KDevelop::ProjectBaseItem* item, const KDevelop::Path& file)
+{
+    KDevelop::Path::List ret;
+    foreach (const QString& source, buildGraph(item).sourcesDependingOn(file.toLocalFile())) {
+        ret << KDevelop::Path(source);
+    }
+    return ret;
+}
+
+int NinjaBuilder::lastBuildDuration(KDevelop::ProjectBaseItem* item, const QStringList& outputs)
+{
+    const NinjaBuildGraph& graph = buildGraph(item);
+    int ret = -1;
+    foreach (const QString& output, outputs) {
+        const int duration = graph.lastDuration(output);
+        if (duration < 0) {
+            return -1;
+        }
+        ret = qMax(ret, 0) + duration;
+    }
+    return ret;
+}
+
 class ErrorJob
     : public KJob
 {
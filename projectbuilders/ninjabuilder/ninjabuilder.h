@@ -21,22 +21,27 @@
 #define KDEVNINJABUILDERPLUGIN_H
 
 #include "ninjajob.h"
+#include "ninjabuildgraph.h"
+#include "ininjabuilder.h"
 
 #include <interfaces/iplugin.h>
-#include <project/interfaces/iprojectbuilder.h>
 #include <util/objectlist.h>
+#include <QFutureWatcher>
+#include <QHash>
 #include <QUrl>
 #include <QVariantList>
 
 class NinjaBuilder
     : public KDevelop::IPlugin
-    , public KDevelop::IProjectBuilder
+    , public INinjaBuilder
 {
     Q_OBJECT
+    Q_INTERFACES(INinjaBuilder)
     Q_INTERFACES(KDevelop::IProjectBuilder)
 
 public:
     explicit NinjaBuilder(QObject* parent = nullptr, const QVariantList& args = QVariantList());
+    ~NinjaBuilder() override;
 
     KJob* build(KDevelop::ProjectBaseItem* item) override;
     KJob* clean(KDevelop::ProjectBaseItem* item) override;
@@ -49,6 +54,10 @@ public:
     int perProjectConfigPages() const override;
     KDevelop::ConfigPage* perProjectConfigPage(int number, const KDevelop::ProjectConfigOptions& options, QWidget* parent) override;
 
+    QStringList outputsForFile(KDevelop::ProjectBaseItem* item, const KDevelop::Path& file) override;
+    KDevelop::Path::List sourcesDependingOn(KDevelop::ProjectBaseItem* item, const KDevelop::Path& file) override;
+    int lastBuildDuration(KDevelop::ProjectBaseItem* item, const QStringList& outputs) override;
+
 Q_SIGNALS:
     void built(KDevelop::ProjectBaseItem* item);
     void failed(KDevelop::ProjectBaseItem* item);
@@ -56,7 +65,21 @@ Q_SIGNALS:
     void cleaned(KDevelop::ProjectBaseItem* item);
 
 private:
+    /**
+     * @return the build graph of the ninja directory of @p item
+     *
+     * If ninja changed its files meanwhile, they are read again in the background and the
+     * previous graph is returned until then. It is empty before the files were read once.
+     */
+    const NinjaBuildGraph& buildGraph(KDevelop::ProjectBaseItem* item);
+    /// Reads the files of the ninja @p directory in the background if they changed
+    void updateBuildGraph(const KDevelop::Path& directory);
+
     KDevelop::ObjectList<NinjaJob> m_activeNinjaJobs;
+    /// ninja directory -> what ninja recorded there
+    QHash<KDevelop::Path, NinjaBuildGraph> m_buildGraphs;
+    /// ninja directory -> the running update of its build graph
+    QHash<KDevelop::Path, QFutureWatcher<NinjaBuildGraph>*> m_buildGraphUpdates;
 };
 
 #endif // KDEVNINJABUILDERPLUGIN_H
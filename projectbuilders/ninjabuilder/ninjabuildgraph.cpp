@@ -0,0 +1,244 @@
+/* This file is part of KDevelop
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+
+#include "ninjabuildgraph.h"
+
+#include "debug.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QtEndian>
+
+namespace {
+// see deps_log.cc in the ninja sources for the format
+const char depsSignature[] = "# ninjadeps\n";
+const quint32 depsRecordFlag = 0x80000000;
+
+const char logSignature[] = "# ninja log v";
+
+qint32 readInt(const char* data)
+{
+    return qFromLittleEndian<qint32>(reinterpret_cast<const uchar*>(data));
+}
+}
+
+NinjaBuildGraph::NinjaBuildGraph(const QString& buildDirectory)
+    : m_buildDirectory(buildDirectory)
+{
+}
+
+QString NinjaBuildGraph::buildDirectory() const
+{
+    return m_buildDirectory;
+}
+
+bool NinjaBuildGraph::isOutdated() const
+{
+    const QDir dir(m_buildDirectory);
+    return QFileInfo(dir.filePath(QStringLiteral(".ninja_deps"))).lastModified() != m_depsModified
+        || QFileInfo(dir.filePath(QStringLiteral(".ninja_log"))).lastModified() != m_logModified;
+}
+
+void NinjaBuildGraph::update()
+{
+    const QDir dir(m_buildDirectory);
+
+    const QFileInfo depsFile(dir.filePath(QStringLiteral(".ninja_deps")));
+    if (depsFile.lastModified() != m_depsModified) {
+        m_depsModified = depsFile.lastModified();
+        if (!readDeps(depsFile.filePath())) {
+            qCDebug(NINJABUILDER) << "could not read" << depsFile.filePath();
+        }
+    }
+
+    const QFileInfo logFile(dir.filePath(QStringLiteral(".ninja_log")));
+    if (logFile.lastModified() != m_logModified) {
+        m_logModified = logFile.lastModified();
+        if (!readLog(logFile.filePath())) {
+            qCDebug(NINJABUILDER) << "could not read" << logFile.filePath();
+        }
+    }
+}
+
+bool NinjaBuildGraph::readDeps(const QString& fileName)
+{
+    m_nodes.clear();
+    m_dependents.clear();
+    m_outputsForSource.clear();
+    m_sourceForOutput.clear();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const QByteArray data = file.readAll();
+    const int signatureSize = sizeof(depsSignature) - 1;
+    if (!data.startsWith(depsSignature) || data.size() < signatureSize + 4) {
+        return false;
+    }
+
+    const char* it = data.constData() + signatureSize;
+    const char* const end = data.constData() + data.size();
+    const int version = readInt(it);
+    it += 4;
+    if (version != 3 && version != 4) {
+        qCDebug(NINJABUILDER) << "unsupported deps log version" << version;
+        return false;
+    }
+    // version 4 has 64 bit mtimes in deps records, both versions have a checksum after each path
+    const int depsHeaderSize = version == 3 ? 8 : 12;
+    const int pathSuffixSize = 4;
+
+    // later records for an output replace earlier ones
+    QHash<int, QVector<int>> deps;
+    while (end - it >= 4) {
+        const quint32 header = readInt(it);
+        const int size = header & ~depsRecordFlag;
+        it += 4;
+        if (size > end - it || size % 4) {
+            // truncated, e.g. because ninja is still writing
+            break;
+        }
+        const char* record = it;
+        it += size;
+
+        if (header & depsRecordFlag) {
+            if (size < depsHeaderSize) {
+                break;
+            }
+            QVector<int> inputs;
+            inputs.reserve((size - depsHeaderSize) / 4);
+            for (const char* input = record + depsHeaderSize; input < record + size; input += 4) {
+                inputs << readInt(input);
+            }
+            deps[readInt(record)] = inputs;
+        } else {
+            int length = size - pathSuffixSize;
+            while (length > 0 && record[length - 1] == '\0') {
+                --length;
+            }
+            m_nodes << QString::fromLocal8Bit(record, length);
+        }
+    }
+
+    QVector<QString> absolutePaths(m_nodes.size());
+    auto absoluteNode = [this, &absolutePaths](int id) -> const QString& {
+        if (absolutePaths[id].isEmpty()) {
+            absolutePaths[id] = absolutePath(m_nodes[id]);
+        }
+        return absolutePaths[id];
+    };
+
+    const int nodeCount = m_nodes.size();
+    for (auto dep = deps.constBegin(); dep != deps.constEnd(); ++dep) {
+        const int output = dep.key();
+        const auto& inputs = *dep;
+        if (output < 0 || output >= nodeCount || inputs.isEmpty() || inputs.first() < 0 || inputs.first() >= nodeCount) {
+            continue;
+        }
+
+        // the depfile written by the compiler lists the source first
+        m_sourceForOutput.insert(output, inputs.first());
+        m_outputsForSource[absoluteNode(inputs.first())] << output;
+        for (int input : inputs) {
+            if (input >= 0 && input < nodeCount) {
+                m_dependents[absoluteNode(input)] << output;
+            }
+        }
+    }
+
+    qCDebug(NINJABUILDER) << "read" << m_nodes.size() << "nodes and" << deps.size() << "outputs from" << fileName;
+    return true;
+}
+
+bool NinjaBuildGraph::readLog(const QString& fileName)
+{
+    m_durations.clear();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const QByteArray header = file.readLine();
+    if (!header.startsWith(logSignature) || header.mid(sizeof(logSignature) - 1).trimmed().toInt() < 4) {
+        return false;
+    }
+
+    // start \t end \t mtime \t output \t hash, later lines replace earlier ones
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+        const int startEnd = line.indexOf('\t');
+        const int endEnd = line.indexOf('\t', startEnd + 1);
+        const int mtimeEnd = line.indexOf('\t', endEnd + 1);
+        const int outputEnd = line.indexOf('\t', mtimeEnd + 1);
+        if (startEnd < 0 || endEnd < 0 || mtimeEnd < 0 || outputEnd < 0) {
+            continue;
+        }
+        const int start = line.left(startEnd).toInt();
+        const int finish = line.mid(startEnd + 1, endEnd - startEnd - 1).toInt();
+        m_durations.insert(QString::fromLocal8Bit(line.constData() + mtimeEnd + 1, outputEnd - mtimeEnd - 1), finish - start);
+    }
+
+    return true;
+}
+
+QString NinjaBuildGraph::absolutePath(const QString& path) const
+{
+    return QDir::cleanPath(QDir(m_buildDirectory).absoluteFilePath(path));
+}
+
+QStringList NinjaBuildGraph::outputsForSource(const QString& source) const
+{
+    QStringList ret;
+    foreach (int output, m_outputsForSource.value(QDir::cleanPath(source))) {
+        ret << m_nodes.at(output);
+    }
+    return ret;
+}
+
+QStringList NinjaBuildGraph::outputsDependingOn(const QString& file) const
+{
+    QStringList ret;
+    foreach (int output, m_dependents.value(QDir::cleanPath(file))) {
+        ret << m_nodes.at(output);
+    }
+    return ret;
+}
+
+QStringList NinjaBuildGraph::sourcesDependingOn(const QString& file) const
+{
+    QSet<int> sources;
+    foreach (int output, m_dependents.value(QDir::cleanPath(file))) {
+        sources.insert(m_sourceForOutput.value(output));
+    }
+
+    QStringList ret;
+    ret.reserve(sources.size());
+    foreach (int source, sources) {
+        ret << absolutePath(m_nodes.at(source));
+    }
+    return ret;
+}
+
+int NinjaBuildGraph::lastDuration(const QString& output) const
+{
+    return m_durations.value(output, -1);
+}
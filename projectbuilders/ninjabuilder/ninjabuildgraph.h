@@ -0,0 +1,81 @@
+/* This file is part of KDevelop
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+
+#ifndef NINJABUILDGRAPH_H
+#define NINJABUILDGRAPH_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * What ninja recorded about previous builds in a build directory.
+ *
+ * Reads the .ninja_deps file (the header dependencies discovered while compiling) and
+ * the .ninja_log file (the duration of each build step) directly, without running ninja.
+ *
+ * Outputs are named as in build.ninja, i.e. usually relative to the build directory,
+ * all other paths are absolute.
+ */
+class NinjaBuildGraph
+{
+public:
+    explicit NinjaBuildGraph(const QString& buildDirectory = QString());
+
+    QString buildDirectory() const;
+
+    /// @return whether the files changed since the last call to update()
+    bool isOutdated() const;
+
+    /// Reads the files again if they changed since the last call.
+    void update();
+
+    /// @return the outputs that were built from @p source, e.g. the object file of a .cpp file
+    QStringList outputsForSource(const QString& source) const;
+
+    /// @return the sources of all outputs that depend on @p file, e.g. the TUs including a header
+    QStringList sourcesDependingOn(const QString& file) const;
+
+    /// @return the outputs that depend on @p file
+    QStringList outputsDependingOn(const QString& file) const;
+
+    /// @return how long building @p output took the last time in ms, or -1 if unknown
+    int lastDuration(const QString& output) const;
+
+private:
+    bool readDeps(const QString& fileName);
+    bool readLog(const QString& fileName);
+    QString absolutePath(const QString& path) const;
+
+    QString m_buildDirectory;
+    QDateTime m_depsModified;
+    QDateTime m_logModified;
+
+    /// the nodes of the deps log, named as ninja knows them
+    QVector<QString> m_nodes;
+    /// absolute path of a dependency -> ids of the outputs depending on it
+    QHash<QString, QVector<int>> m_dependents;
+    /// absolute path of a source -> ids of the outputs built from it
+    QHash<QString, QVector<int>> m_outputsForSource;
+    /// output id -> id of the source it was built from
+    QHash<int, int> m_sourceForOutput;
+    QHash<QString, int> m_durations;
+};
+
+#endif // NINJABUILDGRAPH_H
@@ -34,7 +34,6 @@
 #include <KConfigGroup>
 
 #include <QFile>
-#include <QRegularExpression>
 #include <QStandardPaths>
 #include <QUrl>
 
@@ -49,26 +48,45 @@ public:
     IFilterStrategy::Progress progressInLine(const QString& line) override;
 };
 
+/// Reads the decimal number starting at @p pos, moving @p pos behind it. @return -1 if there is none.
+static int scanNumber(const QString& line, int& pos)
+{
+    int number = -1;
+    for (const int size = line.size(); pos < size; ++pos) {
+        const ushort c = line.at(pos).unicode();
+        if (c < '0' || c > '9') {
+            break;
+        }
+        number = qMax(number, 0) * 10 + (c - '0');
+    }
+    return number;
+}
+
 IFilterStrategy::Progress NinjaJobCompilerFilterStrategy::progressInLine(const QString& line)
 {
     // example string: [87/88] Building CXX object projectbuilders/ninjabuilder/CMakeFiles/kdevninja.dir/ninjajob.cpp.o
-    static const QRegularExpression re("^\\[([0-9]+)\\/([0-9]+)\\] (.*)");
-
-    QRegularExpressionMatch match = re.match(line);
-    if (match.hasMatch()) {
-        const int current = match.capturedRef(1).toInt();
-        const int total = match.capturedRef(2).toInt();
-        if (current && total) {
-            // this is output from ninja
-            const QString action = match.captured(3);
-            const int percent = qRound(( float )current / total * 100);
-            return {
-                       action, percent
-            };
-        }
+    // this is called for every line of output, so don't bother a regular expression with the compiler output
+    if (!line.startsWith(QLatin1Char('['))) {
+        return {};
     }
 
-    return {};
+    int pos = 1;
+    const int current = scanNumber(line, pos);
+    if (current <= 0 || pos >= line.size() || line.at(pos) != QLatin1Char('/')) {
+        return {};
+    }
+    ++pos;
+    const int total = scanNumber(line, pos);
+    if (total <= 0 || pos + 1 >= line.size() || line.at(pos) != QLatin1Char(']') || line.at(pos + 1) != QLatin1Char(' ')) {
+        return {};
+    }
+
+    // this is output from ninja
+    const QString action = line.mid(pos + 2);
+    const int percent = qRound(( float )current / total * 100);
+    return {
+               action, percent
+    };
 }
 
 NinjaJob::NinjaJob(KDevelop::ProjectBaseItem* item, CommandType commandType,
@@ -134,16 +152,21 @@ QUrl NinjaJob::workingDirectory() const
     if (!it) {
         return QUrl();
     }
-    KDevelop::IBuildSystemManager* bsm = it->project()->buildSystemManager();
-    KDevelop::Path workingDir = bsm->buildDirectory(it);
+    return ninjaDirectory(it).toUrl();
+}
+
+KDevelop::Path NinjaJob::ninjaDirectory(KDevelop::ProjectBaseItem* item)
+{
+    KDevelop::IBuildSystemManager* bsm = item->project()->buildSystemManager();
+    KDevelop::Path workingDir = bsm->buildDirectory(item);
     while (!QFile::exists(workingDir.toLocalFile() + "build.ninja")) {
         KDevelop::Path upWorkingDir = workingDir.parent();
         if (!upWorkingDir.isValid() || upWorkingDir == workingDir) {
-            return bsm->buildDirectory(it->project()->projectItem()).toUrl();
+            return bsm->buildDirectory(item->project()->projectItem());
         }
         workingDir = upWorkingDir;
     }
-    return workingDir.toUrl();
+    return workingDir;
 }
 
 QStringList NinjaJob::privilegedExecutionCommand() const
@@ -209,15 +232,16 @@ void NinjaJob::appendLines(const QStringList& lines)
         return;
     }
 
-    QStringList ret(lines);
-    bool prev = false;
-    for (QStringList::iterator it = ret.end(); it != ret.begin(); ) {
-        --it;
-        bool curr = it->startsWith('[');
-        if ((prev && curr) || it->endsWith("] ")) {
-            it = ret.erase(it);
+    // only keep the last of consecutive progress lines and drop bare status lines
+    QStringList ret;
+    ret.reserve(lines.size());
+    for (int i = 0, size = lines.size(); i < size; ++i) {
+        const QString& line = lines.at(i);
+        const bool next = i + 1 < size && lines.at(i + 1).startsWith('[');
+        if ((next && line.startsWith('[')) || line.endsWith("] ")) {
+            continue;
         }
-        prev = curr;
+        ret << line;
     }
 
     model()->appendLines(ret);
@@ -21,6 +21,7 @@
 #define NINJAJOB_H
 
 #include <outputview/outputexecutejob.h>
+#include <util/path.h>
 
 #include <QPointer>
 
@@ -57,6 +58,8 @@ public:
 
     void setIsInstalling(bool isInstalling);
     static QString ninjaExecutable();
+    /// @return the build directory of @p item containing the build.ninja file
+    static KDevelop::Path ninjaDirectory(KDevelop::ProjectBaseItem* item);
 
     KDevelop::ProjectBaseItem* item() const;
     CommandType commandType() const;
@@ -0,0 +1,152 @@
+/* This file is part of KDevelop
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License version 2 as published by the Free Software Foundation.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public License
+   along with this library; see the file COPYING.LIB.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+
+#include "test_ninjabuildgraph.h"
+
+#include "../ninjabuildgraph.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtTest/QTest>
+
+namespace {
+
+/// Writes a .ninja_deps file in the format of deps_log.cc
+class DepsLogWriter
+{
+public:
+    explicit DepsLogWriter(int version)
+        : m_stream(&m_data, QIODevice::WriteOnly)
+        , m_version(version)
+        , m_nodeCount(0)
+    {
+        m_stream.setByteOrder(QDataStream::LittleEndian);
+        m_stream.writeRawData("# ninjadeps\n", 12);
+        m_stream << qint32(version);
+    }
+
+    int addPath(const QByteArray& path)
+    {
+        QByteArray padded = path;
+        while (padded.size() % 4) {
+            padded.append('\0');
+        }
+
+        m_stream << quint32(padded.size() + 4);
+        m_stream.writeRawData(padded.constData(), padded.size());
+        // the checksum of a path record is the complement of its id
+        m_stream << quint32(~m_nodeCount);
+        return m_nodeCount++;
+    }
+
+    void addDeps(int output, const QVector<int>& inputs)
+    {
+        const int mtimeSize = m_version == 3 ? 4 : 8;
+        m_stream << quint32((4 + mtimeSize + inputs.size() * 4) | 0x80000000);
+        m_stream << qint32(output);
+        if (m_version == 3) {
+            m_stream << quint32(1);
+        } else {
+            m_stream << quint64(1);
+        }
+        for (int input : inputs) {
+            m_stream << qint32(input);
+        }
+    }
+
+    QByteArray data() const
+    {
+        return m_data;
+    }
+
+private:
+    QByteArray m_data;
+    QDataStream m_stream;
+    int m_version;
+    int m_nodeCount;
+};
+
+void writeFile(const QString& fileName, const QByteArray& contents)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(contents);
+}
+
+}
+
+void TestNinjaBuildGraph::testBuildGraph_data()
+{
+    QTest::addColumn<int>("version");
+
+    QTest::newRow("v3 (ninja 1.4 - 1.9)") << 3;
+    QTest::newRow("v4 (ninja 1.10)") << 4;
+}
+
+void TestNinjaBuildGraph::testBuildGraph()
+{
+    QFETCH(int, version);
+
+    QTemporaryDir buildDir;
+    QVERIFY(buildDir.isValid());
+
+    DepsLogWriter deps(version);
+    const int object = deps.addPath("src/foo.o");
+    const int source = deps.addPath("../foo.cpp");
+    const int header = deps.addPath("../foo.h");
+    const int otherObject = deps.addPath("src/bar.o");
+    const int otherSource = deps.addPath("../bar.cpp");
+    deps.addDeps(object, {source, header});
+    deps.addDeps(otherObject, {otherSource, header});
+    writeFile(buildDir.path() + QStringLiteral("/.ninja_deps"), deps.data());
+
+    writeFile(buildDir.path() + QStringLiteral("/.ninja_log"),
+              "# ninja log v5\n"
+              "0\t120\t1\tsrc/foo.o\tdeadbeef\n"
+              "5\t40\t1\tsrc/bar.o\tcafebabe\n"
+              // later entries replace earlier ones
+              "200\t250\t2\tsrc/bar.o\tcafebabe\n");
+
+    NinjaBuildGraph graph(buildDir.path());
+    graph.update();
+
+    QDir sourceDir(buildDir.path());
+    sourceDir.cdUp();
+    const QString sourceFile = QDir::cleanPath(sourceDir.filePath(QStringLiteral("foo.cpp")));
+    const QString otherSourceFile = QDir::cleanPath(sourceDir.filePath(QStringLiteral("bar.cpp")));
+    const QString headerFile = QDir::cleanPath(sourceDir.filePath(QStringLiteral("foo.h")));
+
+    QCOMPARE(graph.outputsForSource(sourceFile), QStringList{QStringLiteral("src/foo.o")});
+
+    QStringList outputs = graph.outputsDependingOn(headerFile);
+    outputs.sort();
+    QCOMPARE(outputs, QStringList({QStringLiteral("src/bar.o"), QStringLiteral("src/foo.o")}));
+
+    QStringList sources = graph.sourcesDependingOn(headerFile);
+    sources.sort();
+    QStringList expectedSources = {otherSourceFile, sourceFile};
+    expectedSources.sort();
+    QCOMPARE(sources, expectedSources);
+
+    QCOMPARE(graph.lastDuration(QStringLiteral("src/foo.o")), 120);
+    QCOMPARE(graph.lastDuration(QStringLiteral("src/bar.o")), 50);
+    QCOMPARE(graph.lastDuration(QStringLiteral("unknown.o")), -1);
+}
+
+QTEST_GUILESS_MAIN(TestNinjaBuildGraph)
@@ -28,6 +28,7 @@
 #include "debug.h"
 #include "settings/cmakepreferences.h"
 #include <projectmanagers/custommake/makefileresolver/makefileresolver.h>
+#include <languages/plugins/custom-definesandincludes/idefinesandincludesmanager.h>
 #include "cmakecodecompletionmodel.h"
 #include "cmakenavigationwidget.h"
 #include "icmakedocumentation.h"
@@ -41,6 +42,7 @@
 #include <QThread>
 #include <QFileSystemWatcher>
 #include <QTimer>
+#include <QtConcurrentRun>
 #include <qjsondocument.h>
 
 #include <KPluginFactory>
@@ -143,10 +145,11 @@ class ChooseCMakeInterfaceJob : public ExecuteCompositeJob
 {
     Q_OBJECT
 public:
-    ChooseCMakeInterfaceJob(IProject* project, CMakeManager* manager)
+    ChooseCMakeInterfaceJob(IProject* project, CMakeManager* manager, bool incremental = false)
         : ExecuteCompositeJob(manager, {})
         , project(project)
         , manager(manager)
+        , incremental(incremental)
     {
     }
 
@@ -157,11 +160,26 @@ public:
     }
 
 private:
+    void integrate(const CMakeProjectData& data) {
+        manager->integrateData(data, project, incremental);
+
+        if (data.compilationData.isValid) {
+            const auto snapshotFile = CMake::projectDataSnapshotFile(project);
+            if (!snapshotFile.isEmpty()) {
+                QtConcurrent::run(writeProjectDataSnapshot, snapshotFile, data.compilationData, data.targets, data.m_testSuites);
+            }
+        }
+    }
+
     void successfulConnection() {
         auto job = new CMakeServerImportJob(project, server, this);
+        connect(job, &CMakeServerImportJob::partialDataAvailable, this,
+                [this](const QHash<Path, QStringList>& targets, const CMakeFilesCompilationData& compilationData) {
+            manager->integratePartialData(project, targets, compilationData);
+        });
         connect(job, &CMakeServerImportJob::result, this, [this, job](){
             if (job->error() == 0) {
-                manager->integrateData(job->projectData(), job->project());
+                integrate(job->projectData());
             }
         });
         addSubjob(job);
@@ -187,7 +205,7 @@ private:
 
         connect(job, &CMakeImportJsonJob::result, this, [this, job](){
             if (job->error() == 0) {
-                manager->integrateData(job->projectData(), job->project());
+                integrate(job->projectData());
             }
         });
         addSubjob(job);
@@ -197,17 +215,33 @@ private:
     CMakeServer* server = nullptr;
     IProject* const project;
     CMakeManager* const manager;
+    const bool incremental;
 };
 
 KJob* CMakeManager::createImportJob(ProjectFolderItem* item)
 {
     auto project = item->project();
 
-    auto job = new ChooseCMakeInterfaceJob(project, this);
-    connect(job, &CMakeImportJsonJob::result, this, [this, job, project](){
+    // when opening the project, make the last known state available right away,
+    // the import below reconciles it incrementally once it is done
+    bool fromSnapshot = false;
+    if (!m_projects.contains(project)) {
+        CMakeProjectData snapshot;
+        const auto snapshotFile = CMake::projectDataSnapshotFile(project);
+        if (!snapshotFile.isEmpty() && readProjectDataSnapshot(snapshotFile, &snapshot)) {
+            qCDebug(CMAKE) << "using snapshot" << snapshotFile << "with" << snapshot.compilationData.files.count() << "entries for" << project->name();
+            integrateData(snapshot, project);
+            fromSnapshot = true;
+        }
+    }
+
+    auto job = new ChooseCMakeInterfaceJob(project, this, fromSnapshot);
+    connect(job, &CMakeImportJsonJob::result, this, [this, job, project, fromSnapshot](){
         if (job->error() != 0) {
             qCWarning(CMAKE) << "couldn't load json successfully" << project->name();
-            m_projects.remove(project);
+            // keep the snapshot around, it is the best information we have
+            if (!fromSnapshot)
+                m_projects.remove(project);
         }
     });
 
@@ -220,6 +254,9 @@ KJob* CMakeManager::createImportJob(ProjectFolderItem* item)
     ExecuteCompositeJob* composite = new ExecuteCompositeJob(this, jobs);
 //     even if the cmake call failed, we want to load the project so that the project can be worked on
     composite->setAbortOnError(false);
+    connect(composite, &KJob::finished, this, [this, project]() {
+        importFinished(project);
+    });
     return composite;
 }
 
@@ -310,10 +347,8 @@ bool CMakeManager::reload(KDevelop::ProjectFolderItem* folder)
     return true;
 }
 
-static void populateTargets(ProjectFolderItem* folder, const QHash<KDevelop::Path, QStringList>& targets)
+static void populateFolderTargets(ProjectFolderItem* folder, QStringList dirTargets)
 {
-    QStringList dirTargets = targets[folder->path()];
-
     foreach (ProjectTargetItem* item, folder->targetList()) {
         if(!dirTargets.contains(item->text())) {
             delete item;
@@ -337,22 +372,111 @@ static void populateTargets(ProjectFolderItem* folder, const QHash<KDevelop::Pat
         )
             new CMakeTargetItem(folder, name);
     }
+}
+
+static void populateTargets(ProjectFolderItem* folder, const QHash<KDevelop::Path, QStringList>& targets)
+{
+    populateFolderTargets(folder, targets[folder->path()]);
 
     foreach (ProjectFolderItem* children, folder->folderList()) {
         populateTargets(children, targets);
     }
 }
 
-void CMakeManager::integrateData(const CMakeProjectData &data, KDevelop::IProject* project)
+static bool operator==(const Test& a, const Test& b)
+{
+    return a.name == b.name && a.executable == b.executable
+        && a.arguments == b.arguments && a.properties == b.properties;
+}
+
+/**
+ * Only updates what differs between @p oldData and @p newData: the targets of folders whose
+ * target list changed and the parse jobs of files whose compile flags changed.
+ */
+static void integrateChanges(const CMakeProjectData& oldData, const CMakeProjectData& newData, IProject* project)
+{
+    QSet<Path> targetDirs = oldData.targets.keys().toSet();
+    targetDirs.unite(newData.targets.keys().toSet());
+    foreach (const Path& dir, targetDirs) {
+        const QStringList dirTargets = newData.targets.value(dir);
+        if (dirTargets == oldData.targets.value(dir))
+            continue;
+
+        foreach (ProjectFolderItem* folder, project->foldersForPath(IndexedString(dir.pathOrUrl()))) {
+            populateFolderTargets(folder, dirTargets);
+        }
+    }
+
+    const auto& oldFiles = oldData.compilationData.files;
+    const auto& newFiles = newData.compilationData.files;
+    QSet<Path> changedFiles;
+    for (auto it = newFiles.constBegin(), itEnd = newFiles.constEnd(); it != itEnd; ++it) {
+        auto oldIt = oldFiles.constFind(it.key());
+        if (oldIt == oldFiles.constEnd() || *oldIt != *it)
+            changedFiles.insert(it.key());
+    }
+    for (auto it = oldFiles.constBegin(), itEnd = oldFiles.constEnd(); it != itEnd; ++it) {
+        if (!newFiles.contains(it.key()))
+            changedFiles.insert(it.key());
+    }
+
+    if (!changedFiles.isEmpty()) {
+        IDefinesAndIncludesManager::manager()->projectSpecificFlagsChanged(project, changedFiles.toList().toVector());
+    }
+
+    if (!(oldData.m_testSuites == newData.m_testSuites)) {
+        CTestUtils::createTestSuites(newData.m_testSuites, project);
+    }
+
+    qCDebug(CMAKE) << "incrementally integrated" << project->name() << ":" << changedFiles.size() << "files with changed flags";
+}
+
+void CMakeManager::integrateData(const CMakeProjectData &data, KDevelop::IProject* project, bool incremental)
 {
     connect(data.watcher.data(), &QFileSystemWatcher::fileChanged, this, &CMakeManager::dirtyFile);
     connect(data.watcher.data(), &QFileSystemWatcher::directoryChanged, this, &CMakeManager::dirtyFile);
+
+    auto it = m_projects.find(project);
+    if (incremental && it != m_projects.end() && it->compilationData.isValid) {
+        if (!data.compilationData.isValid) {
+            qCDebug(CMAKE) << "keeping previous data for" << project->name() << ", the import did not yield anything";
+            return;
+        }
+
+        const CMakeProjectData oldData = *it;
+        *it = data;
+        integrateChanges(oldData, data, project);
+        return;
+    }
+
     m_projects[project] = data;
 
     populateTargets(project->projectItem(), data.targets);
     CTestUtils::createTestSuites(data.m_testSuites, project);
 }
 
+void CMakeManager::integratePartialData(IProject* project, const QHash<Path, QStringList>& targets,
+                                        const CMakeFilesCompilationData& compilationData)
+{
+    auto& data = m_projects[project];
+    if (data.compilationData.isValid) {
+        // the final result will be compared against what we have
+        return;
+    }
+
+    for (auto it = compilationData.files.constBegin(), itEnd = compilationData.files.constEnd(); it != itEnd; ++it) {
+        data.compilationData.files.insert(it.key(), *it);
+    }
+
+    for (auto it = targets.constBegin(), itEnd = targets.constEnd(); it != itEnd; ++it) {
+        auto& dirTargets = data.targets[it.key()];
+        dirTargets += *it;
+        foreach (ProjectFolderItem* folder, project->foldersForPath(IndexedString(it.key().pathOrUrl()))) {
+            populateFolderTargets(folder, dirTargets);
+        }
+    }
+}
+
 // void CMakeManager::deletedWatchedDirectory(IProject* p, const QUrl &dir)
 // {
 //     if(p->folder().equals(dir, QUrl::CompareWithoutTrailingSlash)) {
@@ -819,6 +943,10 @@ QPair<QString, QString> CMakeManager::cacheValue(KDevelop::IProject* /*project*/
 void CMakeManager::projectClosing(IProject* p)
 {
     m_projects.remove(p);
+    m_dirtyProjects.remove(p);
+    if (KJob* job = m_incrementalJobs.take(p)) {
+        job->kill();
+    }
 //     delete m_projectsData.take(p);
 //     delete m_watchers.take(p);
 //
@@ -883,15 +1011,44 @@ void CMakeManager::dirtyFile(const QString& path)
 {
     qCDebug(CMAKE) << "dirty!" << path;
 
-    //we initialize again hte project that sent the signal
+    //we only re-read the build system data of the project that sent the signal, the file system
+    //listing is kept up to date by AbstractFileManagerPlugin already
     for(QHash<IProject*, CMakeProjectData>::const_iterator it = m_projects.constBegin(), itEnd = m_projects.constEnd(); it!=itEnd; ++it) {
         if(it->watcher == sender()) {
-            reload(it.key()->projectItem());
+            IProject* project = it.key();
+            // a running import might have read the file before it changed, the project
+            // is refreshed once more when it is done
+            if (!project->isReady() || m_incrementalJobs.value(project)) {
+                m_dirtyProjects.insert(project);
+                break;
+            }
+
+            startIncrementalImport(project);
             break;
         }
     }
 }
 
+void CMakeManager::startIncrementalImport(IProject* project)
+{
+    m_dirtyProjects.remove(project);
+
+    auto job = new ChooseCMakeInterfaceJob(project, this, true);
+    m_incrementalJobs[project] = job;
+    connect(job, &KJob::finished, this, [this, project]() {
+        m_incrementalJobs.remove(project);
+        importFinished(project);
+    });
+    ICore::self()->runController()->registerJob(job);
+}
+
+void CMakeManager::importFinished(IProject* project)
+{
+    if (m_dirtyProjects.contains(project) && m_projects.contains(project)) {
+        startIncrementalImport(project);
+    }
+}
+
 void CMakeManager::folderAdded(KDevelop::ProjectFolderItem* folder)
 {
     populateTargets(folder, m_projects[folder->project()].targets);
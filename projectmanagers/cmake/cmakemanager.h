@@ -23,9 +23,13 @@
 #define CMAKEMANAGER_H
 
 #include <QList>
+#include <QPointer>
+#include <QSet>
 #include <QString>
 #include <QtCore/QVariant>
 
+#include <KJob>
+
 #include <project/interfaces/iprojectfilemanager.h>
 #include <project/interfaces/ibuildsystemmanager.h>
 #include <project/abstractfilemanagerplugin.h>
@@ -137,7 +141,22 @@ public:
     int perProjectConfigPages() const override;
     KDevelop::ConfigPage* perProjectConfigPage(int number, const KDevelop::ProjectConfigOptions& options, QWidget* parent) override;
 
-    void integrateData(const CMakeProjectData &data, KDevelop::IProject* project);
+    /**
+     * Takes over @p data as the build system information of @p project.
+     *
+     * When @p incremental is set and data for the project is already known, only the folders,
+     * files and tests that changed are updated instead of repopulating the whole project.
+     */
+    void integrateData(const CMakeProjectData &data, KDevelop::IProject* project, bool incremental = false);
+
+    /**
+     * Adds the targets and files of a part of an import that is still running to @p project,
+     * so that it becomes usable before the import finished.
+     *
+     * Does nothing if complete data for the project is known already.
+     */
+    void integratePartialData(KDevelop::IProject* project, const QHash<KDevelop::Path, QStringList>& targets,
+                              const CMakeFilesCompilationData& compilationData);
 
 signals:
     void folderRenamed(const KDevelop::Path& oldFolder, KDevelop::ProjectFolderItem* newFolder);
@@ -158,7 +177,16 @@ private:
 
     void folderAdded(KDevelop::ProjectFolderItem* folder);
 
+    /// Re-reads the build system data of @p project, see integrateData()
+    void startIncrementalImport(KDevelop::IProject* project);
+    /// Refreshes @p project once more if it changed while it was imported
+    void importFinished(KDevelop::IProject* project);
+
     QHash<KDevelop::IProject*, CMakeProjectData> m_projects;
+    /// the running incremental import of each project, there is at most one
+    QHash<KDevelop::IProject*, QPointer<KJob>> m_incrementalJobs;
+    /// the projects that changed during an import
+    QSet<KDevelop::IProject*> m_dirtyProjects;
     KDevelop::ProjectFilterManager* m_filter;
     KDevelop::ICodeHighlighting* m_highlight;
 };
@@ -24,6 +24,33 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QFileInfo>
+#include <QDataStream>
+#include <QSaveFile>
+
+namespace {
+const quint32 snapshotMagic = 0x4b444350; // "KDCP"
+const quint32 snapshotVersion = 1;
+
+QStringList toStringList(const KDevelop::Path::List& paths)
+{
+    QStringList ret;
+    ret.reserve(paths.size());
+    for (const auto& path : paths) {
+        ret << path.pathOrUrl();
+    }
+    return ret;
+}
+
+KDevelop::Path::List toPathList(const QStringList& paths)
+{
+    KDevelop::Path::List ret;
+    ret.reserve(paths.size());
+    for (const auto& path : paths) {
+        ret << KDevelop::Path(path);
+    }
+    return ret;
+}
+}
 
 CMakeProjectData::CMakeProjectData(const QHash<KDevelop::Path, QStringList>& targets, const CMakeFilesCompilationData& data, const QVector<Test>& tests)
     : compilationData(data)
@@ -32,3 +59,96 @@ CMakeProjectData::CMakeProjectData(const QHash<KDevelop::Path, QStringList>& tar
     , m_testSuites(tests)
 {
 }
+
+bool writeProjectDataSnapshot(const KDevelop::Path& file, const CMakeFilesCompilationData& compilationData,
+                              const QHash<KDevelop::Path, QStringList>& targets, const QVector<Test>& testSuites)
+{
+    if (!compilationData.isValid) {
+        return false;
+    }
+
+    QSaveFile output(file.toLocalFile());
+    if (!output.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&output);
+    stream.setVersion(QDataStream::Qt_5_4);
+    stream << snapshotMagic << snapshotVersion;
+
+    stream << compilationData.files.size();
+    for (auto it = compilationData.files.constBegin(), itEnd = compilationData.files.constEnd(); it != itEnd; ++it) {
+        stream << it.key().pathOrUrl() << toStringList(it->includes) << toStringList(it->frameworkDirectories) << it->defines;
+    }
+
+    stream << targets.size();
+    for (auto it = targets.constBegin(), itEnd = targets.constEnd(); it != itEnd; ++it) {
+        stream << it.key().pathOrUrl() << *it;
+    }
+
+    stream << testSuites.size();
+    for (const auto& test : testSuites) {
+        stream << test.name << test.executable.pathOrUrl() << test.arguments << test.properties;
+    }
+
+    return stream.status() == QDataStream::Ok && output.commit();
+}
+
+bool readProjectDataSnapshot(const KDevelop::Path& file, CMakeProjectData* data)
+{
+    QFile input(file.toLocalFile());
+    if (!input.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&input);
+    stream.setVersion(QDataStream::Qt_5_4);
+    quint32 magic = 0, version = 0;
+    stream >> magic >> version;
+    if (magic != snapshotMagic || version != snapshotVersion) {
+        return false;
+    }
+
+    CMakeFilesCompilationData compilationData;
+    int count = 0;
+    stream >> count;
+    compilationData.files.reserve(count);
+    for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString path;
+        QStringList includes, frameworkDirectories;
+        CMakeFile cmakeFile;
+        stream >> path >> includes >> frameworkDirectories >> cmakeFile.defines;
+        cmakeFile.includes = toPathList(includes);
+        cmakeFile.frameworkDirectories = toPathList(frameworkDirectories);
+        compilationData.files.insert(KDevelop::Path(path), cmakeFile);
+    }
+
+    QHash<KDevelop::Path, QStringList> targets;
+    stream >> count;
+    for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString path;
+        QStringList names;
+        stream >> path >> names;
+        targets.insert(KDevelop::Path(path), names);
+    }
+
+    QVector<Test> testSuites;
+    stream >> count;
+    for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        Test test;
+        QString executable;
+        stream >> test.name >> executable >> test.arguments >> test.properties;
+        test.executable = KDevelop::Path(executable);
+        testSuites << test;
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    compilationData.isValid = true;
+    data->compilationData = compilationData;
+    data->targets = targets;
+    data->m_testSuites = testSuites;
+    return true;
+}
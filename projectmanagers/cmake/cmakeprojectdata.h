@@ -44,6 +44,14 @@ struct CMakeFile
     KDevelop::Path::List frameworkDirectories;
     QHash<QString, QString> defines;
 };
+inline bool operator==(const CMakeFile& a, const CMakeFile& b)
+{
+    return a.includes == b.includes && a.frameworkDirectories == b.frameworkDirectories && a.defines == b.defines;
+}
+inline bool operator!=(const CMakeFile& a, const CMakeFile& b)
+{
+    return !(a == b);
+}
 inline QDebug &operator<<(QDebug debug, const CMakeFile& file)
 {
     debug << "CMakeFile(-I" << file.includes << ", -F" << file.frameworkDirectories << ", -D" << file.defines << ")";
@@ -71,4 +79,22 @@ struct CMakeProjectData
     QVector<Test> m_testSuites;
 };
 
+/**
+ * Writes the targets, compilation data and tests of an import to @p file, so that they
+ * are available immediately when the project is opened the next time.
+ *
+ * This can be called from a background thread.
+ *
+ * @return true on success, false otherwise
+ */
+bool writeProjectDataSnapshot(const KDevelop::Path& file, const CMakeFilesCompilationData& compilationData,
+                              const QHash<KDevelop::Path, QStringList>& targets, const QVector<Test>& testSuites);
+
+/**
+ * Reads a snapshot written with writeProjectDataSnapshot() from @p file into @p data.
+ *
+ * @return true on success, false if the file is missing, of another version or corrupted
+ */
+bool readProjectDataSnapshot(const KDevelop::Path& file, CMakeProjectData* data);
+
 #endif
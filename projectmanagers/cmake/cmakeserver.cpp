@@ -27,6 +27,7 @@
 #include <QJsonArray>
 #include <QTimer>
 #include <QTemporaryFile>
+#include <QtConcurrentRun>
 #include "debug.h"
 
 CMakeServer::CMakeServer(QObject* parent)
@@ -121,17 +122,20 @@ void CMakeServer::processOutput()
     for(; m_buffer.size() > openTag.size(); ) {
 
         Q_ASSERT(m_buffer.startsWith(openTag));
-        const int idx = m_buffer.indexOf(closeTag, openTag.size());
+        const int idx = m_buffer.indexOf(closeTag, qMax(openTag.size(), m_searchOffset));
         if (idx >= 0) {
             emitResponse(m_buffer.mid(openTag.size(), idx - openTag.size()));
             m_buffer = m_buffer.mid(idx + closeTag.size());
+            m_searchOffset = 0;
         } else {
+            // big replies arrive in many chunks, don't search the part we already looked at again
+            m_searchOffset = m_buffer.size() - closeTag.size() + 1;
             break;
         }
     }
 }
 
-void CMakeServer::emitResponse(const QByteArray& data)
+static QJsonObject parseResponse(const QByteArray& data)
 {
     QJsonParseError error;
     auto doc = QJsonDocument::fromJson(data, &error);
@@ -139,7 +143,32 @@ void CMakeServer::emitResponse(const QByteArray& data)
         qCWarning(CMAKE) << "error processing" << error.errorString() << data;
     }
     Q_ASSERT(doc.isObject());
-    Q_EMIT response(doc.object());
+    return doc.object();
+}
+
+void CMakeServer::emitResponse(const QByteArray& data)
+{
+    // most responses are tiny, but the codemodel can be hundreds of MB, parse those in a worker thread.
+    // Responses that arrive in the meantime are queued behind it so that the order is kept.
+    if (data.size() < 64 * 1024 && m_pendingResponses.isEmpty()) {
+        Q_EMIT response(parseResponse(data));
+        return;
+    }
+
+    auto watcher = new QFutureWatcher<QJsonObject>(this);
+    connect(watcher, &QFutureWatcher<QJsonObject>::finished, this, &CMakeServer::emitPendingResponses);
+    m_pendingResponses.enqueue(watcher);
+    watcher->setFuture(QtConcurrent::run(parseResponse, data));
+}
+
+void CMakeServer::emitPendingResponses()
+{
+    while (!m_pendingResponses.isEmpty() && m_pendingResponses.head()->isFinished()) {
+        auto watcher = m_pendingResponses.dequeue();
+        const auto object = watcher->result();
+        watcher->deleteLater();
+        Q_EMIT response(object);
+    }
 }
 
 void CMakeServer::handshake(const KDevelop::Path& source, const KDevelop::Path& build)
@@ -24,6 +24,9 @@
 #include <util/path.h>
 #include <QProcess>
 #include <QLocalSocket>
+#include <QFutureWatcher>
+#include <QJsonObject>
+#include <QQueue>
 #include "cmakecommonexport.h"
 
 class KDEVCMAKECOMMON_EXPORT CMakeServer : public QObject
@@ -50,10 +53,13 @@ Q_SIGNALS:
 private:
     void processOutput();
     void emitResponse(const QByteArray &data);
+    void emitPendingResponses();
     void setConnected(bool connected);
 
     QLocalSocket* m_localSocket;
     QByteArray m_buffer;
+    int m_searchOffset = 0;
+    QQueue<QFutureWatcher<QJsonObject>*> m_pendingResponses;
     QProcess m_process;
     bool m_connected = false;
 };
@@ -24,6 +24,7 @@
 #include <interfaces/iproject.h>
 #include <QJsonArray>
 #include <QRegularExpression>
+#include <QtConcurrentMap>
 #include "debug.h"
 #include <projectmanagers/custommake/makefileresolver/makefileresolver.h>
 
@@ -80,37 +81,42 @@ static QHash<QString, QString> processDefines(const QString &compileFlags, const
     return ret;
 }
 
-static void processFileData(const QJsonObject &response, CMakeProjectData &data)
+static CodeModelChunk processProjectData(const QJsonObject &project)
 {
-    const auto configs = response.value(QLatin1String("configurations")).toArray();
-    qCDebug(CMAKE) << "process response" << response;
-    for (const auto &config: configs) {
-        const auto projects = config.toObject().value(QLatin1String("projects")).toArray();
-        for (const auto &project: projects) {
-            const auto targets = project.toObject().value(QLatin1String("targets")).toArray();
-            for (const auto &targetObject: targets) {
-                const auto target = targetObject.toObject();
-                const KDevelop::Path targetDir(target.value(QLatin1String("sourceDirectory")).toString());
-
-                data.targets[targetDir] += target.value(QLatin1String("name")).toString();
-
-                const auto fileGroups = target.value(QLatin1String("fileGroups")).toArray();
-                for (const auto &fileGroupValue: fileGroups) {
-                    const auto fileGroup = fileGroupValue.toObject();
-                    CMakeFile file;
-                    file.includes = kTransform<KDevelop::Path::List>(fileGroup.value(QLatin1String("includePath")).toArray(), [](const QJsonValue& val) { return KDevelop::Path(val.toObject().value(QLatin1String("path")).toString()); });
-                    file.defines = processDefines(fileGroup.value(QLatin1String("compileFlags")).toString(), fileGroup.value(QLatin1String("defines")).toArray());
-
-                    const auto sourcesArray = fileGroup.value(QLatin1String("sources")).toArray();
-                    const KDevelop::Path::List sources = kTransform<KDevelop::Path::List>(sourcesArray, [targetDir](const QJsonValue& val) { return KDevelop::Path(targetDir, val.toString()); });
-                    for (const auto& source: sources) {
-                        data.compilationData.files[source] = file;
-                    }
-                    qCDebug(CMAKE) << "registering..." << sources << file;
-                }
+    CodeModelChunk data;
+    const auto targets = project.value(QLatin1String("targets")).toArray();
+    for (const auto &targetObject: targets) {
+        const auto target = targetObject.toObject();
+        const KDevelop::Path targetDir(target.value(QLatin1String("sourceDirectory")).toString());
+
+        data.targets[targetDir] += target.value(QLatin1String("name")).toString();
+
+        const auto fileGroups = target.value(QLatin1String("fileGroups")).toArray();
+        for (const auto &fileGroupValue: fileGroups) {
+            const auto fileGroup = fileGroupValue.toObject();
+            CMakeFile file;
+            file.includes = kTransform<KDevelop::Path::List>(fileGroup.value(QLatin1String("includePath")).toArray(), [](const QJsonValue& val) { return KDevelop::Path(val.toObject().value(QLatin1String("path")).toString()); });
+            file.defines = processDefines(fileGroup.value(QLatin1String("compileFlags")).toString(), fileGroup.value(QLatin1String("defines")).toArray());
+
+            const auto sourcesArray = fileGroup.value(QLatin1String("sources")).toArray();
+            const KDevelop::Path::List sources = kTransform<KDevelop::Path::List>(sourcesArray, [targetDir](const QJsonValue& val) { return KDevelop::Path(targetDir, val.toString()); });
+            for (const auto& source: sources) {
+                data.compilationData.files[source] = file;
             }
         }
     }
+    data.compilationData.isValid = true;
+    return data;
+}
+
+static void mergeChunk(const CodeModelChunk &chunk, CMakeProjectData &data)
+{
+    for (auto it = chunk.targets.constBegin(), itEnd = chunk.targets.constEnd(); it != itEnd; ++it) {
+        data.targets[it.key()] += *it;
+    }
+    for (auto it = chunk.compilationData.files.constBegin(), itEnd = chunk.compilationData.files.constEnd(); it != itEnd; ++it) {
+        data.compilationData.files[it.key()] = *it;
+    }
 }
 
 CMakeServerImportJob::CMakeServerImportJob(KDevelop::IProject* project, CMakeServer* server, QObject* parent)
@@ -122,6 +128,16 @@ CMakeServerImportJob::CMakeServerImportJob(KDevelop::IProject* project, CMakeSer
         setError(UnexpectedDisconnect);
         emitResult();
     });
+    connect(&m_futureWatcher, &QFutureWatcher<CodeModelChunk>::resultReadyAt, this, [this](int index) {
+        const auto chunk = m_futureWatcher.resultAt(index);
+        Q_EMIT partialDataAvailable(chunk.targets, chunk.compilationData);
+    });
+    connect(&m_futureWatcher, &QFutureWatcher<CodeModelChunk>::finished, this, &CMakeServerImportJob::codeModelProcessed);
+}
+
+CMakeServerImportJob::~CMakeServerImportJob()
+{
+    m_futureWatcher.cancel();
 }
 
 void CMakeServerImportJob::start()
@@ -152,8 +168,7 @@ void CMakeServerImportJob::processResponse(const QJsonObject& response)
         } else if (inReplyTo == QLatin1String("compute")) {
             m_server->codemodel();
         } else if(inReplyTo == QLatin1String("codemodel")) {
-            processFileData(response, m_data);
-            emitResult();
+            processCodeModel(response);
         } else {
             qWarning() << "unhandled reply" << response;
         }
@@ -166,3 +181,32 @@ void CMakeServerImportJob::processResponse(const QJsonObject& response)
         qWarning() << "unhandled message" << response;
     }
 }
+
+void CMakeServerImportJob::processCodeModel(const QJsonObject& response)
+{
+    // nothing else is expected from the server, don't let it interfere while we are processing
+    disconnect(m_server.data(), nullptr, this, nullptr);
+
+    QVector<QJsonObject> projects;
+    const auto configs = response.value(QLatin1String("configurations")).toArray();
+    for (const auto &config: configs) {
+        const auto configProjects = config.toObject().value(QLatin1String("projects")).toArray();
+        for (const auto &project: configProjects) {
+            projects += project.toObject();
+        }
+    }
+    qCDebug(CMAKE) << "processing codemodel with" << projects.size() << "projects";
+
+    m_futureWatcher.setFuture(QtConcurrent::mapped(projects, processProjectData));
+}
+
+void CMakeServerImportJob::codeModelProcessed()
+{
+    // merge in order, so that later configurations win like they did before
+    const auto future = m_futureWatcher.future();
+    for (int i = 0, count = future.resultCount(); i < count; ++i) {
+        mergeChunk(future.resultAt(i), m_data);
+    }
+    m_data.compilationData.isValid = true;
+    emitResult();
+}
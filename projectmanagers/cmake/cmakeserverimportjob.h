@@ -22,8 +22,16 @@
 #define CMAKESERVERIMPORTJOB_H
 
 #include <KJob>
+#include <QFutureWatcher>
 #include "cmakeprojectdata.h"
 
+/// The targets and files of one project in one configuration of the codemodel
+struct CodeModelChunk
+{
+    QHash<KDevelop::Path, QStringList> targets;
+    CMakeFilesCompilationData compilationData;
+};
+
 namespace KDevelop
 {
 class IProject;
@@ -34,6 +42,7 @@ class CMakeServerImportJob : public KJob
     Q_OBJECT
 public:
     CMakeServerImportJob(KDevelop::IProject* project, CMakeServer* server, QObject* parent);
+    ~CMakeServerImportJob() override;
 
     enum Error { NoError, UnexpectedDisconnect, ErrorResponse };
 
@@ -43,14 +52,26 @@ public:
 
     CMakeProjectData projectData() const { return m_data; }
 
+Q_SIGNALS:
+    /**
+     * Emitted while the codemodel is processed in the background, once for each of its projects.
+     *
+     * This allows to integrate the data progressively, the complete data is available through
+     * projectData() once the job finished.
+     */
+    void partialDataAvailable(const QHash<KDevelop::Path, QStringList>& targets, const CMakeFilesCompilationData& compilationData);
+
 private:
     void doStart();
     void processResponse(const QJsonObject &response);
+    void processCodeModel(const QJsonObject &response);
+    void codeModelProcessed();
 
     QPointer<CMakeServer> m_server;
     KDevelop::IProject* m_project;
 
     CMakeProjectData m_data;
+    QFutureWatcher<CodeModelChunk> m_futureWatcher;
 };
 
 #endif // CMAKESERVERIMPORTJOB_H
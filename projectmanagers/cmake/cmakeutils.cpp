@@ -293,6 +293,16 @@ KDevelop::Path targetDirectoriesFile(KDevelop::IProject* project)
     return KDevelop::Path(currentBuildDir, QStringLiteral("CMakeFiles/TargetDirectories.txt"));
 }
 
+KDevelop::Path projectDataSnapshotFile(KDevelop::IProject* project)
+{
+    auto currentBuildDir = CMake::currentBuildDir(project);
+    if (currentBuildDir.isEmpty()) {
+        return {};
+    }
+
+    return KDevelop::Path(currentBuildDir, QStringLiteral("CMakeFiles/KDevelopProjectData.bin"));
+}
+
 QString currentBuildType( KDevelop::IProject* project )
 {
     return readProjectParameter( project, Config::Specific::cmakeBuildTypeKey, "Release" );
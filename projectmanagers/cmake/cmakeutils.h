@@ -63,6 +63,11 @@ namespace CMake
      * or an empty url if none has been set by the user.
      */
     KDEVCMAKECOMMON_EXPORT KDevelop::Path targetDirectoriesFile( KDevelop::IProject* project );
+    /**
+     * @returns the path to the snapshot of the last successful import in the current builddir for the given project
+     * or an empty url if none has been set by the user.
+     */
+    KDEVCMAKECOMMON_EXPORT KDevelop::Path projectDataSnapshotFile( KDevelop::IProject* project );
 
     /**
      * @returns the current build type for the given project or "Release" as default value.
@@ -22,6 +22,7 @@
 #include "cmakemodelitems.h"
 #include "cmakeutils.h"
 #include "cmakeimportjsonjob.h"
+#include "cmakeprojectdata.h"
 #include <icmakemanager.h>
 
 #include <qtest.h>
@@ -347,3 +348,48 @@ void TestCMakeManager::testParenthesesInTestArguments()
     job->start();
 
 }
+
+void TestCMakeManager::testProjectDataSnapshot()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const Path snapshotFile(dir.path() + "/snapshot");
+    const Path sourceDir(dir.path());
+
+    CMakeFilesCompilationData compilationData;
+    CMakeFile file;
+    file.includes = {Path(sourceDir, "include")};
+    file.frameworkDirectories = {Path(sourceDir, "frameworks")};
+    file.defines = {{QStringLiteral("FOO"), QStringLiteral("1")}, {QStringLiteral("BAR"), QString()}};
+    compilationData.files.insert(Path(sourceDir, "main.cpp"), file);
+    compilationData.files.insert(Path(sourceDir, "other.cpp"), CMakeFile());
+
+    const QHash<Path, QStringList> targets = {{sourceDir, {QStringLiteral("app"), QStringLiteral("lib")}}};
+
+    Test test;
+    test.name = QStringLiteral("apptest");
+    test.executable = Path(sourceDir, "apptest");
+    test.arguments = QStringList{QStringLiteral("-v")};
+    test.properties.insert(QStringLiteral("WILL_FAIL"), QStringLiteral("TRUE"));
+
+    // invalid data must not replace a good snapshot
+    QVERIFY(!writeProjectDataSnapshot(snapshotFile, CMakeFilesCompilationData(), targets, {test}));
+
+    compilationData.isValid = true;
+    QVERIFY(writeProjectDataSnapshot(snapshotFile, compilationData, targets, {test}));
+
+    CMakeProjectData data;
+    QVERIFY(readProjectDataSnapshot(snapshotFile, &data));
+    QVERIFY(data.compilationData.isValid);
+    QCOMPARE(data.compilationData.files.size(), 2);
+    QVERIFY(data.compilationData.files.value(Path(sourceDir, "main.cpp")) == file);
+    QVERIFY(data.compilationData.files.value(Path(sourceDir, "other.cpp")) == CMakeFile());
+    QCOMPARE(data.targets, targets);
+    QCOMPARE(data.m_testSuites.size(), 1);
+    QCOMPARE(data.m_testSuites.first().name, test.name);
+    QCOMPARE(data.m_testSuites.first().executable, test.executable);
+    QCOMPARE(data.m_testSuites.first().arguments, test.arguments);
+    QCOMPARE(data.m_testSuites.first().properties, test.properties);
+
+    QVERIFY(!readProjectDataSnapshot(Path(dir.path() + "/missing"), &data));
+}
@@ -52,6 +52,7 @@ private slots:
     void testEnumerateTargets();
     void testFaultyTarget();
     void testParenthesesInTestArguments();
+    void testProjectDataSnapshot();
 };
 
 #endif // TEST_CMAKEMANAGER_H
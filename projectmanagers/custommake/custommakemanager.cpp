@@ -14,6 +14,7 @@
 #include <interfaces/icore.h>
 #include <interfaces/iproject.h>
 #include <interfaces/iprojectcontroller.h>
+#include <interfaces/isession.h>
 #include <interfaces/iplugincontroller.h>
 #include <makebuilder/imakebuilder.h>
 #include <kpluginfactory.h>
@@ -31,6 +32,7 @@
 #include <QReadLocker>
 #include <QWriteLocker>
 #include <QUrl>
+#include <QStandardPaths>
 #include <QLoggingCategory>
 Q_DECLARE_LOGGING_CATEGORY(CUSTOMMAKE)
 Q_LOGGING_CATEGORY(CUSTOMMAKE, "kdevelop.projectmanagers.custommake")
@@ -45,13 +47,25 @@ Q_LOGGING_CATEGORY(CUSTOMMAKE, "kdevelop.projectmanagers.custommake")
 
 using namespace KDevelop;
 
+namespace {
+/// the include paths resolved by make are kept across runs of a session, so we don't have to re-run make for all directories on every start.
+/// Instances of KDevelop can't share a session, so they don't overwrite each other's results.
+QString resolverCacheFile()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + QLatin1String("/kdevelop/custommake_includepaths_")
+        + ICore::self()->activeSession()->id().toString();
+}
+}
+
 class CustomMakeProvider : public IDefinesAndIncludesManager::BackgroundProvider
 {
 public:
     explicit CustomMakeProvider(CustomMakeManager* manager)
         : m_customMakeManager(manager)
         , m_resolver(new MakeFileResolver())
-    {}
+    {
+        m_resolver->enableBatchedResolution(true);
+    }
 
     // NOTE: Fixes build failures for GCC versions <4.8.
     // cf. https://gcc.gnu.org/bugzilla/show_bug.cgi?id=53613
@@ -134,6 +148,8 @@ CustomMakeManager::CustomMakeManager( QObject *parent, const QVariantList& args
 
 
     IDefinesAndIncludesManager::manager()->registerBackgroundProvider(m_provider.data());
+
+    MakeFileResolver::loadCache(resolverCacheFile());
 }
 
 CustomMakeManager::~CustomMakeManager()
@@ -328,6 +344,16 @@ void CustomMakeManager::projectClosing(IProject* project)
 void CustomMakeManager::unload()
 {
   IDefinesAndIncludesManager::manager()->unregisterBackgroundProvider(m_provider.data());
+
+  const auto statistics = MakeFileResolver::cacheStatistics();
+  qCDebug(CUSTOMMAKE) << "include path cache: hits" << statistics.hits << "misses" << statistics.misses
+                      << "make invocations" << statistics.makeInvocations << "entries" << statistics.entries;
+
+  const QString cacheFile = resolverCacheFile();
+  QDir().mkpath(QFileInfo(cacheFile).absolutePath());
+  if (!MakeFileResolver::saveCache(cacheFile)) {
+    qCWarning(CUSTOMMAKE) << "failed to save the include path cache to" << cacheFile;
+  }
 }
 
 #include "custommakemanager.moc"
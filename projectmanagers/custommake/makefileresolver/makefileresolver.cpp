@@ -24,12 +24,15 @@
 
 #include "helper.h"
 
+#include <algorithm>
 #include <memory>
 #include <cstdio>
 #include <iostream>
 
+#include <QDataStream>
 #include <QDir>
 #include <QFileInfo>
+#include <QSaveFile>
 #include <QRegularExpression>
 #include <QRegExp>
 
@@ -59,24 +62,161 @@ namespace {
 
   static const int processTimeoutSeconds = 30;
 
+  ///Include-paths of a single file, as resolved by a batched make dry-run
+  struct FileCacheEntry
+  {
+    Path::List paths;
+    Path::List frameworkDirectories;
+    QHash<QString, QString> defines;
+  };
+
   struct CacheEntry
   {
     CacheEntry()
       : failed(false)
     { }
     ModificationRevisionSet modificationTime;
+    ///Results of batched resolution for the files in this directory, keyed by file-name
+    QHash<QString, FileCacheEntry> files;
     Path::List paths;
     Path::List frameworkDirectories;
     QHash<QString, QString> defines;
     QString errorMessage, longErrorMessage;
     bool failed;
+    ///Whether batched resolution missed files of this directory, which are then resolved one by one
+    bool unbatchable = false;
     QMap<QString,bool> failedFiles;
     QDateTime failTime;
+    ///The Makefile the entry was resolved from, and its modification-time back then. Used to restore saved entries.
+    QString makeFile;
+    QDateTime makeFileTime;
+    ///Value of the use-counter of the cache when this entry was last used
+    quintptr lastUse = 0;
+  };
+
+  ///Process-global cache of the resolution results for each build-directory.
+  ///It is split into shards with separate locks, so background parse threads resolving files in different
+  ///directories don't contend on a single mutex, and bounded by evicting the least recently used directories.
+  class Cache
+  {
+  public:
+    ///Copies the entry for directory into entry, and marks it as used
+    bool find(const QString& directory, CacheEntry* entry)
+    {
+      Shard& s = shard(directory);
+      QMutexLocker l(&s.mutex);
+      auto it = s.entries.find(directory);
+      if (it == s.entries.end())
+        return false;
+      it->lastUse = m_useCounter.fetchAndAddRelaxed(1);
+      *entry = *it;
+      return true;
+    }
+
+    void insert(const QString& directory, const CacheEntry& entry)
+    {
+      Shard& s = shard(directory);
+      QMutexLocker l(&s.mutex);
+      CacheEntry& inserted = s.entries[directory];
+      inserted = entry;
+      inserted.lastUse = m_useCounter.fetchAndAddRelaxed(1);
+
+      const int capacity = qMax(1, m_capacity.load() / ShardCount);
+      while (s.entries.size() > capacity) {
+        auto leastRecentlyUsed = std::min_element(s.entries.begin(), s.entries.end(), [](const CacheEntry& lhs, const CacheEntry& rhs) {
+          return lhs.lastUse < rhs.lastUse;
+        });
+        s.entries.erase(leastRecentlyUsed);
+      }
+    }
+
+    void clear()
+    {
+      for (Shard& s : m_shards) {
+        QMutexLocker l(&s.mutex);
+        s.entries.clear();
+      }
+    }
+
+    int size() const
+    {
+      int size = 0;
+      for (const Shard& s : m_shards) {
+        QMutexLocker l(&s.mutex);
+        size += s.entries.size();
+      }
+      return size;
+    }
+
+    void setCapacity(int capacity)
+    {
+      m_capacity.store(capacity);
+    }
+
+    QHash<QString, CacheEntry> entries() const
+    {
+      QHash<QString, CacheEntry> ret;
+      for (const Shard& s : m_shards) {
+        QMutexLocker l(&s.mutex);
+        ret.unite(s.entries);
+      }
+      return ret;
+    }
+
+  private:
+    enum { ShardCount = 16 };
+
+    struct Shard
+    {
+      mutable QMutex mutex;
+      QHash<QString, CacheEntry> entries;
+    };
+
+    Shard& shard(const QString& directory)
+    {
+      return m_shards[qHash(directory) % ShardCount];
+    }
+
+    Shard m_shards[ShardCount];
+    QAtomicInt m_capacity {4096};
+    QAtomicInteger<quintptr> m_useCounter {0};
   };
-  typedef QMap<QString, CacheEntry> Cache;
 
   static Cache s_cache;
-  static QMutex s_cacheMutex;
+
+  // pointer sized, 64 bit atomics are not available on every platform
+
+  static QAtomicInteger<quintptr> s_cacheHits {0};
+  static QAtomicInteger<quintptr> s_cacheMisses {0};
+  static QAtomicInteger<quintptr> s_makeInvocations {0};
+
+  static const quint32 cacheFileMagic = 0x4b444d52; // "KDMR"
+  static const quint32 cacheFileVersion = 1;
+
+  static QStringList toStringList(const Path::List& paths)
+  {
+    QStringList ret;
+    ret.reserve(paths.size());
+    foreach (const Path& path, paths)
+      ret << path.pathOrUrl();
+    return ret;
+  }
+
+  static Path::List toPathList(const QStringList& paths)
+  {
+    Path::List ret;
+    ret.reserve(paths.size());
+    foreach (const QString& path, paths)
+      ret << Path(path);
+    return ret;
+  }
+
+  ///Name-filters for the source-files which are resolved together in batched mode
+  static const QStringList& sourceFileFilters()
+  {
+    static const QStringList filters = {"*.c", "*.cc", "*.cpp", "*.cxx", "*.c++", "*.C", "*.m", "*.mm"};
+    return filters;
+  }
 }
 
   /**
@@ -185,6 +325,7 @@ bool MakeFileResolver::executeCommand(const QString& command, const QString& wor
   QString prog = args.takeFirst();
   proc.setProgram(prog, args);
 
+  s_makeInvocations.fetchAndAddRelaxed(1);
   int status = proc.execute(processTimeoutSeconds * 1000);
   result = proc.readAll();
 
@@ -194,10 +335,17 @@ bool MakeFileResolver::executeCommand(const QString& command, const QString& wor
 MakeFileResolver::MakeFileResolver()
   : m_isResolving(false)
   , m_outOfSource(false)
+  , m_batchedResolution(false)
+{
+}
+
+void MakeFileResolver::enableBatchedResolution(bool enable)
 {
+  m_batchedResolution = enable;
 }
 
 ///More efficient solution: Only do exactly one call for each directory. During that call, mark all source-files as changed, and make all targets for those files.
+///This is what enableBatchedResolution() does.
 PathResolutionResult MakeFileResolver::resolveIncludePath(const QString& file)
 {
   if (file.isEmpty()) {
@@ -223,10 +371,95 @@ QString MakeFileResolver::mapToBuild(const QString &path) const
 
 void MakeFileResolver::clearCache()
 {
-  QMutexLocker l(&s_cacheMutex);
   s_cache.clear();
 }
 
+void MakeFileResolver::setCacheCapacity(int directories)
+{
+  s_cache.setCapacity(directories);
+}
+
+MakeFileResolver::CacheStatistics MakeFileResolver::cacheStatistics()
+{
+  CacheStatistics statistics;
+  statistics.hits = s_cacheHits.load();
+  statistics.misses = s_cacheMisses.load();
+  statistics.makeInvocations = s_makeInvocations.load();
+  statistics.entries = s_cache.size();
+  return statistics;
+}
+
+bool MakeFileResolver::saveCache(const QString& fileName)
+{
+  QSaveFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly))
+    return false;
+
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_5_4);
+  stream << cacheFileMagic << cacheFileVersion;
+
+  const auto entries = s_cache.entries();
+  for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+    //Failed results are retried anyway
+    if (it->failed || it->makeFile.isEmpty())
+      continue;
+    stream << it.key() << it->makeFile << it->makeFileTime
+           << toStringList(it->paths) << toStringList(it->frameworkDirectories) << it->defines;
+    stream << it->files.size();
+    for (auto fileIt = it->files.constBegin(); fileIt != it->files.constEnd(); ++fileIt) {
+      stream << fileIt.key() << toStringList(fileIt->paths) << toStringList(fileIt->frameworkDirectories) << fileIt->defines;
+    }
+  }
+
+  return stream.status() == QDataStream::Ok && file.commit();
+}
+
+bool MakeFileResolver::loadCache(const QString& fileName)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly))
+    return false;
+
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_5_4);
+  quint32 magic = 0, version = 0;
+  stream >> magic >> version;
+  if (magic != cacheFileMagic || version != cacheFileVersion)
+    return false;
+
+  while (!stream.atEnd() && stream.status() == QDataStream::Ok) {
+    QString directory;
+    CacheEntry entry;
+    QStringList paths, frameworkDirectories;
+    int fileCount = 0;
+    stream >> directory >> entry.makeFile >> entry.makeFileTime
+           >> paths >> frameworkDirectories >> entry.defines;
+    entry.paths = toPathList(paths);
+    entry.frameworkDirectories = toPathList(frameworkDirectories);
+    stream >> fileCount;
+    for (int i = 0; i < fileCount && stream.status() == QDataStream::Ok; ++i) {
+      QString name;
+      FileCacheEntry fileEntry;
+      stream >> name >> paths >> frameworkDirectories >> fileEntry.defines;
+      fileEntry.paths = toPathList(paths);
+      fileEntry.frameworkDirectories = toPathList(frameworkDirectories);
+      entry.files.insert(name, fileEntry);
+    }
+    if (stream.status() != QDataStream::Ok)
+      break;
+
+    //Only restore entries whose Makefile is unchanged, they are validated like fresh entries from then on
+    if (QFileInfo(entry.makeFile).lastModified() != entry.makeFileTime)
+      continue;
+    IndexedString makeFile(entry.makeFile);
+    entry.modificationTime.addModificationRevision(makeFile, ModificationRevision::revisionForFile(makeFile));
+    s_cache.insert(directory, entry);
+  }
+
+  return stream.status() == QDataStream::Ok;
+}
+
 PathResolutionResult MakeFileResolver::resolveIncludePath(const QString& file, const QString& _workingDirectory, int maxStepsUp)
 {
   //Prefer this result when returning a "fail". The include-paths of this result will always be added.
@@ -290,41 +523,48 @@ PathResolutionResult MakeFileResolver::resolveIncludePath(const QString& file, c
   ModificationRevisionSet dependency;
   dependency.addModificationRevision(IndexedString(makeFile.filePath()), ModificationRevision::revisionForFile(IndexedString(makeFile.filePath())));
   dependency += resultOnFail.includePathDependency;
-  Cache::iterator it;
-  {
-    QMutexLocker l(&s_cacheMutex);
-    it = s_cache.find(dir.path());
-    if (it != s_cache.end()) {
-      cachedPaths = it->paths;
-      cachedFWDirs = it->frameworkDirectories;
-      cachedDefines = it->defines;
-      if (dependency == it->modificationTime) {
-        if (!it->failed) {
-          //We have a valid cached result
-          PathResolutionResult ret(true);
-          ret.paths = it->paths;
-          ret.frameworkDirectories = it->frameworkDirectories;
-          ret.defines = it->defines;
+  CacheEntry cached;
+  if (s_cache.find(dir.path(), &cached)) {
+    cachedPaths = cached.paths;
+    cachedFWDirs = cached.frameworkDirectories;
+    cachedDefines = cached.defines;
+    if (dependency == cached.modificationTime) {
+      //A batched result of the file is valid, even if resolving another file of the directory failed
+      auto fileEntry = cached.files.constFind(file);
+      if (!cached.failed || fileEntry != cached.files.constEnd()) {
+        //We have a valid cached result
+        s_cacheHits.fetchAndAddRelaxed(1);
+        PathResolutionResult ret(true);
+        if (fileEntry != cached.files.constEnd()) {
+          ret.paths = fileEntry->paths;
+          ret.frameworkDirectories = fileEntry->frameworkDirectories;
+          ret.defines = fileEntry->defines;
+        } else {
+          ret.paths = cached.paths;
+          ret.frameworkDirectories = cached.frameworkDirectories;
+          ret.defines = cached.defines;
+        }
+        ret.mergeWith(resultOnFail);
+        return ret;
+      } else {
+        //We have a cached failed result. We should use that for some time but then try again. Return the failed result if: (there were too many tries within this folder OR this file was already tried) AND The last tries have not expired yet
+        if (/*(cached.failedFiles.size() > 3 || cached.failedFiles.find(file) != cached.failedFiles.end()) &&*/ cached.failTime.secsTo(QDateTime::currentDateTime()) < CACHE_FAIL_FOR_SECONDS) {
+          s_cacheHits.fetchAndAddRelaxed(1);
+          PathResolutionResult ret(false); //Fake that the result is ok
+          ret.errorMessage = i18n("Cached: %1", cached.errorMessage);
+          ret.longErrorMessage = cached.longErrorMessage;
+          ret.paths = cached.paths;
+          ret.frameworkDirectories = cached.frameworkDirectories;
+          ret.defines = cached.defines;
           ret.mergeWith(resultOnFail);
           return ret;
         } else {
-          //We have a cached failed result. We should use that for some time but then try again. Return the failed result if: (there were too many tries within this folder OR this file was already tried) AND The last tries have not expired yet
-          if (/*(it->failedFiles.size() > 3 || it->failedFiles.find(file) != it->failedFiles.end()) &&*/ it->failTime.secsTo(QDateTime::currentDateTime()) < CACHE_FAIL_FOR_SECONDS) {
-            PathResolutionResult ret(false); //Fake that the result is ok
-            ret.errorMessage = i18n("Cached: %1", it->errorMessage);
-            ret.longErrorMessage = it->longErrorMessage;
-            ret.paths = it->paths;
-            ret.frameworkDirectories = it->frameworkDirectories;
-            ret.defines = it->defines;
-            ret.mergeWith(resultOnFail);
-            return ret;
-          } else {
-            //Try getting a correct result again
-          }
+          //Try getting a correct result again
         }
       }
     }
   }
+  s_cacheMisses.fetchAndAddRelaxed(1);
 
   ///STEP 1: Prepare paths
   QString targetName;
@@ -352,6 +592,46 @@ PathResolutionResult MakeFileResolver::resolveIncludePath(const QString& file, c
 
   wd = mapToBuild(wd);
 
+  ///STEP 2: In batched mode, resolve all files of the directory at once and cache them
+  if (m_batchedResolution && !file.contains('/') && !(cached.unbatchable && cached.modificationTime == dependency)) {
+    const auto results = resolveIncludePathsBatched(sourceDir.absolutePath(), wd);
+
+    //Keep the results for the other files of the directory, also if this one is missing from them
+    if (!(cached.modificationTime == dependency)) {
+      cached.files.clear();
+      cached.unbatchable = false;
+    }
+    cached.modificationTime = dependency;
+    cached.makeFile = makeFile.filePath();
+    cached.makeFileTime = makeFile.lastModified();
+    for (auto resultIt = results.constBegin(); resultIt != results.constEnd(); ++resultIt) {
+      FileCacheEntry& fileEntry = cached.files[resultIt.key()];
+      fileEntry.paths = resultIt->paths;
+      fileEntry.frameworkDirectories = resultIt->frameworkDirectories;
+      fileEntry.defines = resultIt->defines;
+    }
+
+    auto fileResult = results.constFind(file);
+    if (fileResult != results.constEnd()) {
+      CacheEntry ce(cached);
+      ce.paths = fileResult->paths;
+      ce.frameworkDirectories = fileResult->frameworkDirectories;
+      ce.defines = fileResult->defines;
+      ce.failed = false;
+      ce.failedFiles.clear();
+      s_cache.insert(dir.path(), ce);
+
+      PathResolutionResult ret = *fileResult;
+      ret.includePathDependency = dependency;
+      ret.mergeWith(resultOnFail);
+      return ret;
+    }
+
+    //Don't run the batch again for every file it misses, the entry is stored below
+    cached.unbatchable = true;
+    ifTest(cout << "batched resolution did not resolve " << file.toLocal8Bit().data() << ", falling back" << endl;)
+  }
+
   SourcePathInformation source(wd);
   QStringList possibleTargets = source.possibleTargets(targetName);
 
@@ -378,11 +658,11 @@ PathResolutionResult MakeFileResolver::resolveIncludePath(const QString& file, c
   }
 
   {
-    QMutexLocker l(&s_cacheMutex);
-    if (it == s_cache.end())
-      it = s_cache.insert(dir.path(), CacheEntry());
-
-    CacheEntry& ce(*it);
+    CacheEntry ce(cached);
+    if (!(ce.modificationTime == dependency))
+      ce.files.clear();
+    ce.makeFile = makeFile.filePath();
+    ce.makeFileTime = makeFile.lastModified();
     ce.paths = res.paths;
     ce.frameworkDirectories = res.frameworkDirectories;
     ce.modificationTime = dependency;
@@ -397,6 +677,7 @@ PathResolutionResult MakeFileResolver::resolveIncludePath(const QString& file, c
       ce.failed = false;
       ce.failedFiles.clear();
     }
+    s_cache.insert(dir.path(), ce);
   }
 
 
@@ -525,6 +806,70 @@ PathResolutionResult MakeFileResolver::resolveIncludePathInternal(const QString&
   return ret;
 }
 
+QHash<QString, PathResolutionResult> MakeFileResolver::resolveIncludePathsBatched(const QString& sourceDirectory, const QString& workingDirectory)
+{
+  QHash<QString, PathResolutionResult> results;
+
+  const QStringList sources = QDir(sourceDirectory).entryList(sourceFileFilters(), QDir::Files);
+  if (sources.isEmpty())
+    return results;
+
+  ///Mark all sources as changed, and ask for all their possible targets in one call
+  SourcePathInformation source(workingDirectory);
+  const Path workingPath(workingDirectory);
+  QStringList args = {"-k", "--no-print-directory", "-n"};
+  QStringList targets;
+  foreach (const QString& sourceFile, sources) {
+    const QString absoluteFile = QDir::cleanPath(sourceDirectory + '/' + sourceFile);
+    args << "-W" << absoluteFile << "-W" << workingPath.relativePath(Path(absoluteFile));
+    targets << source.possibleTargets(sourceFile.left(sourceFile.lastIndexOf('.')));
+  }
+  args << targets;
+
+  ifTest(cout << "batched make call for " << sources.size() << " files in " << workingDirectory.toUtf8().constData() << endl);
+
+  KProcess proc;
+  proc.setWorkingDirectory(workingDirectory);
+  proc.setOutputChannelMode(KProcess::MergedChannels);
+  proc.setProgram("make", args);
+  s_makeInvocations.fetchAndAddRelaxed(1);
+  proc.execute(processTimeoutSeconds * 1000);
+  QString fullOutput = proc.readAll();
+
+  {
+    QRegExp newLineRx("\\\\\\n");
+    fullOutput.replace(newLineRx, "");
+  }
+
+  ///Map each compiler-call in the output to the source-file it compiles. Only the absolute path identifies it,
+  ///with -k or recursive makes the output may also compile files of the same name in other directories.
+  QHash<QString, QString> sourceForPath;
+  foreach (const QString& sourceFile, sources)
+    sourceForPath.insert(QDir::cleanPath(sourceDirectory + '/' + sourceFile), sourceFile);
+
+  foreach (const QString& line, fullOutput.split('\n', QString::SkipEmptyParts)) {
+    QString compiledFile;
+    foreach (QString argument, line.split(' ', QString::SkipEmptyParts)) {
+      if (argument.length() > 2 && (argument.startsWith('"') || argument.startsWith('\'')) && argument.endsWith(argument.left(1)))
+        argument = argument.mid(1, argument.length() - 2);
+      if (QFileInfo(argument).isRelative())
+        argument = workingDirectory + '/' + argument;
+      compiledFile = sourceForPath.value(QDir::cleanPath(argument));
+      if (!compiledFile.isEmpty())
+        break;
+    }
+    if (compiledFile.isEmpty() || results.contains(compiledFile))
+      continue;
+
+    //The regular expressions need the surrounding whitespace
+    PathResolutionResult ret = processOutput(' ' + line + '\n', workingDirectory);
+    if (!ret.paths.isEmpty() || !ret.frameworkDirectories.isEmpty())
+      results.insert(compiledFile, ret);
+  }
+
+  return results;
+}
+
 QRegularExpression MakeFileResolver::defineRegularExpression()
 {
   static const QRegularExpression pattern(
@@ -67,10 +67,30 @@ class MakeFileResolver
     void resetOutOfSourceBuild();
 
     static void clearCache();
+    ///Limits the process-global cache to the given number of directories, the least recently used ones are evicted first
+    static void setCacheCapacity(int directories);
+
+    struct CacheStatistics
+    {
+      quint64 hits = 0;
+      quint64 misses = 0;
+      quint64 makeInvocations = 0;
+      int entries = 0;
+    };
+    ///Statistics of the process-global cache, for tuning
+    static CacheStatistics cacheStatistics();
+
+    ///Writes the successful results of the cache to fileName, so they can be restored in a later session
+    static bool saveCache(const QString& fileName);
+    ///Restores the results written by saveCache(), skipping the ones whose Makefile was modified since
+    static bool loadCache(const QString& fileName);
 
     KDevelop::ModificationRevisionSet findIncludePathDependency(const QString& file);
 
     void enableMakeResolution(bool enable);
+    ///When enabled, the include-paths of all sources in a directory are resolved with a single make dry-run
+    ///the first time any of them is requested, and cached for each of the files.
+    void enableBatchedResolution(bool enable);
     PathResolutionResult processOutput(const QString& fullOutput, const QString& workingDirectory) const;
 
     static QRegularExpression defineRegularExpression();
@@ -80,11 +100,14 @@ class MakeFileResolver
 
     bool m_isResolving;
     bool m_outOfSource;
+    bool m_batchedResolution;
 
     QString mapToBuild(const QString &path) const;
 
     ///Executes the command using KProcess
     bool executeCommand( const QString& command, const QString& workingDirectory, QString& result ) const;
+    ///Runs one make dry-run for all source-files in sourceDirectory, and returns the results for each file-name that could be resolved
+    QHash<QString, PathResolutionResult> resolveIncludePathsBatched( const QString& sourceDirectory, const QString& workingDirectory );
     ///file should be the name of the target, without extension(because that may be different)
     PathResolutionResult resolveIncludePathInternal( const QString& file, const QString& workingDirectory,
                                                       const QString& makeParameters, const SourcePathInformation& source, int maxDepth );
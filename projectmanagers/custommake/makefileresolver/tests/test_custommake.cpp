@@ -118,6 +118,68 @@ void TestCustomMake::testDefines()
     QCOMPARE(result.defines.value("END", "not found"), QString());
 }
 
+void TestCustomMake::testBatchedResolution()
+{
+    QTemporaryDir tempDir;
+    {
+        QFile file( tempDir.path() + "/Makefile" );
+        createFile( file );
+        QFile firstFile( tempDir.path() + "/first.cpp" );
+        createFile(firstFile);
+        QFile secondFile( tempDir.path() + "/second.cpp" );
+        createFile(secondFile);
+        QTextStream stream1( &file );
+        stream1 << "first.o:\n\t g++ -c first.cpp -I/firstInclude -DFIRST -o first.o\n"
+                << "second.o:\n\t g++ -c second.cpp -I/secondInclude -DSECOND -o second.o\n";
+    }
+
+    MakeFileResolver mf;
+    mf.enableBatchedResolution(true);
+    auto result = mf.resolveIncludePath(tempDir.path() + "/first.cpp");
+    if (!result.success) {
+      qDebug() << result.errorMessage << result.longErrorMessage;
+      QFAIL("Failed to resolve include path.");
+    }
+    QCOMPARE(result.paths, Path::List{Path("/firstInclude")});
+    QVERIFY(result.defines.contains("FIRST"));
+
+    // the second file got resolved by the same make call and is served from the cache
+    result = mf.resolveIncludePath(tempDir.path() + "/second.cpp");
+    QVERIFY(result.success);
+    QCOMPARE(result.paths, Path::List{Path("/secondInclude")});
+    QVERIFY(result.defines.contains("SECOND"));
+}
+
+void TestCustomMake::testCachePersistence()
+{
+    QTemporaryDir tempDir;
+    {
+        QFile file( tempDir.path() + "/Makefile" );
+        createFile( file );
+        QFile testfile( tempDir.path() + "/testfile.cpp" );
+        createFile(testfile);
+        QTextStream stream1( &file );
+        stream1 << "testfile.o:\n\t g++ testfile.cpp -I/persistedInclude -o testfile";
+    }
+
+    MakeFileResolver mf;
+    QVERIFY(mf.resolveIncludePath(tempDir.path() + "/testfile.cpp").success);
+
+    const QString cacheFile = tempDir.path() + "/cache";
+    QVERIFY(MakeFileResolver::saveCache(cacheFile));
+    MakeFileResolver::clearCache();
+    QVERIFY(MakeFileResolver::loadCache(cacheFile));
+
+    // the restored result is used without running make again
+    const auto before = MakeFileResolver::cacheStatistics();
+    auto result = mf.resolveIncludePath(tempDir.path() + "/testfile.cpp");
+    const auto after = MakeFileResolver::cacheStatistics();
+    QVERIFY(result.success);
+    QCOMPARE(result.paths, Path::List{Path("/persistedInclude")});
+    QCOMPARE(after.makeInvocations, before.makeInvocations);
+    QCOMPARE(after.hits, before.hits + 1);
+}
+
 QTEST_GUILESS_MAIN(TestCustomMake)
 
 #include "moc_test_custommake.cpp"
@@ -34,6 +34,8 @@ private slots:
     void testIncludeDirectories();
     void testFrameworkDirectories();
     void testDefines();
+    void testBatchedResolution();
+    void testCachePersistence();
 };
 
 #endif // TEST_CUSTOMMAKE_H
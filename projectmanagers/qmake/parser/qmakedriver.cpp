@@ -60,6 +60,10 @@ void Driver::setContent(const QString& content)
 {
     m_content = content;
 }
+QString Driver::content() const
+{
+    return m_content;
+}
 void Driver::setDebug(bool debug)
 {
     m_debug = debug;
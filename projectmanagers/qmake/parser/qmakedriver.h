@@ -37,6 +37,7 @@ class KDEVQMAKEPARSER_EXPORT Driver
         Driver();
         bool readFile( const QString&, const char* = nullptr );
         void setContent( const QString& );
+        QString content() const;
         void setDebug( bool );
         bool parse( ProjectAST** ast );
     private:
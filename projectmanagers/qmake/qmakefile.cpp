@@ -20,8 +20,11 @@
 
 #include "qmakefile.h"
 
+#include <QtCore/QCache>
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QDir>
 #include <QtCore/QFileInfo>
+#include <QtCore/QMutex>
 #include <QtCore/QProcessEnvironment>
 #include <QDebug>
 
@@ -86,9 +89,41 @@ QStringList resolveShellGlobbingInternal(const QString& pattern, const QString&
     return resolveShellGlobbingInternal(pattern.split(QLatin1Char('/'), QString::SkipEmptyParts), dir_);
 }
 
+namespace {
+/// .pri files and mkspecs are read again for every file including them, keep their ASTs around.
+/// The key is a hash of the content, so modified files are simply parsed again.
+QMutex s_astCacheMutex;
+QCache<QByteArray, QSharedPointer<QMake::ProjectAST>> s_astCache(1000);
+
+QSharedPointer<QMake::ProjectAST> parse(QMake::Driver& driver)
+{
+    const QString content = driver.content();
+    const QByteArray key = QCryptographicHash::hash(
+        QByteArray::fromRawData(reinterpret_cast<const char*>(content.constData()), content.size() * sizeof(QChar)),
+        QCryptographicHash::Md5);
+
+    {
+        QMutexLocker lock(&s_astCacheMutex);
+        if (auto ast = s_astCache.object(key)) {
+            return *ast;
+        }
+    }
+
+    QMake::ProjectAST* ast = nullptr;
+    if (!driver.parse(&ast)) {
+        delete ast;
+        return {};
+    }
+
+    QSharedPointer<QMake::ProjectAST> ret(ast);
+    QMutexLocker lock(&s_astCacheMutex);
+    s_astCache.insert(key, new QSharedPointer<QMake::ProjectAST>(ret));
+    return ret;
+}
+}
+
 QMakeFile::QMakeFile(QString file)
-    : m_ast(nullptr)
-    , m_projectFile(std::move(file))
+    : m_projectFile(std::move(file))
     , m_project(nullptr)
 {
     Q_ASSERT(!m_projectFile.isEmpty());
@@ -115,17 +150,16 @@ bool QMakeFile::read()
     QMake::Driver d;
     d.readFile(m_projectFile);
 
-    if (!d.parse(&m_ast)) {
+    m_ast = parse(d);
+    if (!m_ast) {
         qCWarning(KDEV_QMAKE) << "Couldn't parse project:" << m_projectFile;
-        delete m_ast;
-        m_ast = nullptr;
         m_projectFile = QString();
         return false;
     } else {
         ifDebug(qCDebug(KDEV_QMAKE) << "found ast:" << m_ast->statements.count();) QMakeFileVisitor visitor(this, this);
         /// TODO: cleanup, re-use m_variableValues directly in the visitor
         visitor.setVariables(m_variableValues);
-        m_variableValues = visitor.visitFile(m_ast);
+        m_variableValues = visitor.visitFile(m_ast.data());
         ifDebug(qCDebug(KDEV_QMAKE) << "Variables found:" << m_variableValues;)
     }
     return true;
@@ -133,8 +167,6 @@ bool QMakeFile::read()
 
 QMakeFile::~QMakeFile()
 {
-    delete m_ast;
-    m_ast = nullptr;
 }
 
 QString QMakeFile::absoluteDir() const
@@ -149,7 +181,7 @@ QString QMakeFile::absoluteFile() const
 
 QMake::ProjectAST* QMakeFile::ast() const
 {
-    return m_ast;
+    return m_ast.data();
 }
 
 QStringList QMakeFile::variables() const
@@ -23,6 +23,7 @@
 
 
 #include <util/stack.h>
+#include <QtCore/QSharedPointer>
 #include <QtCore/QStringList>
 
 #include "qmakefilevisitor.h"
@@ -68,7 +69,8 @@ protected:
     QStringList resolveFileName( const QString& file ) const;
     QString resolveToSingleFileName( const QString& file ) const;
 private:
-    QMake::ProjectAST* m_ast;
+    /// shared with all other files of the same content, see QMakeFile::read()
+    QSharedPointer<QMake::ProjectAST> m_ast;
     QString m_projectFile;
     KDevelop::IProject* m_project;
 };
@@ -28,6 +28,7 @@
 #include <QHash>
 #include <QList>
 #include <QUrl>
+#include <QtConcurrentRun>
 
 #include <kio/global.h>
 #include <KConfigGroup>
@@ -72,6 +73,23 @@ QMakeFolderItem* findQMakeFolderParent(ProjectBaseItem* item)
     return p;
 }
 
+/// @return the .pro file QMakeFile::read() would pick for the SUBDIRS entry @p subProject
+static QString projectFileForSubProject(const QString& subProject)
+{
+    const QFileInfo info(subProject);
+    if (!info.isDir()) {
+        return subProject;
+    }
+
+    const QDir dir(subProject);
+    const QStringList proFiles = dir.entryList(QStringList() << "*.pro", QDir::Files);
+    if (proFiles.isEmpty()) {
+        return QString();
+    }
+    const QString defaultName = info.baseName() + ".pro";
+    return dir.absoluteFilePath(proFiles.contains(defaultName) ? defaultName : proFiles.first());
+}
+
 // END Helpers
 
 K_PLUGIN_FACTORY_WITH_JSON(QMakeSupportFactory, "kdevqmakemanager.json", registerPlugin<QMakeProjectManager>();)
@@ -102,10 +120,20 @@ QMakeProjectManager::QMakeProjectManager(QObject* parent, const QVariantList&)
 
     m_runQMake = new QAction(QIcon::fromTheme("qtlogo"), i18n("Run QMake"), this);
     connect(m_runQMake, SIGNAL(triggered(bool)), this, SLOT(slotRunQMake()));
+
+    connect(ICore::self()->projectController(), &IProjectController::projectClosing, this,
+            &QMakeProjectManager::discardEvaluatedProjectFiles);
 }
 
 QMakeProjectManager::~QMakeProjectManager()
 {
+    QMutexLocker lock(&m_evaluationMutex);
+    const auto projects = m_evaluatedProjectFiles.keys();
+    lock.unlock();
+    foreach (IProject* project, projects) {
+        discardEvaluatedProjectFiles(project);
+    }
+
     m_self = nullptr;
 }
 
@@ -197,6 +225,15 @@ ProjectFolderItem* QMakeProjectManager::projectRootItem(IProject* project, const
     }
     scope->read();
     qCDebug(KDEV_QMAKE) << "top-level scope with variables:" << scope->variables();
+
+    // the file system listing creates the folder items one by one, evaluate what they need in the meantime
+    discardEvaluatedProjectFiles(project);
+    QSharedPointer<QAtomicInt> canceled;
+    {
+        QMutexLocker lock(&m_evaluationMutex);
+        canceled = m_evaluatedProjectFiles[project].canceled;
+    }
+    evaluateSubProjects(project, scope, canceled);
     auto item = new QMakeFolderItem(project, path);
     item->addProjectFile(scope);
     return item;
@@ -236,6 +273,13 @@ ProjectFolderItem* QMakeProjectManager::buildFolderItem(IProject* project, const
         if (!parentPro && file.endsWith(".pri")) {
             continue;
         }
+        if (parentPro) {
+            if (QMakeProjectFile* evaluated = takeEvaluatedProjectFile(project, absFile)) {
+                qCDebug(KDEV_QMAKE) << "add evaluated project file:" << absFile;
+                folderItem->addProjectFile(evaluated);
+                continue;
+            }
+        }
         qCDebug(KDEV_QMAKE) << "add project file:" << absFile;
         if (parentPro) {
             qCDebug(KDEV_QMAKE) << "parent:" << parentPro->absoluteFile();
@@ -476,6 +520,118 @@ QMakeCache* QMakeProjectManager::findQMakeCache(IProject* project, const Path& p
     return nullptr;
 }
 
+void QMakeProjectManager::evaluateSubProjects(IProject* project, QMakeProjectFile* pro,
+                                              const QSharedPointer<QAtomicInt>& canceled)
+{
+    // NOTE: this is called from the evaluation threads as well
+    QMakeMkSpecs* mkspecs = pro->mkSpecs();
+    QMakeCache* parentCache = pro->qmakeCache();
+
+    foreach (const QString& subProject, pro->subProjects()) {
+        const QString file = projectFileForSubProject(subProject);
+        if (file.isEmpty() || !file.endsWith(".pro")) {
+            continue;
+        }
+        // the same key as in takeEvaluatedProjectFile()
+        const QString canonicalFile = QFileInfo(file).canonicalFilePath();
+        if (canonicalFile.isEmpty()) {
+            continue;
+        }
+
+        QMutexLocker lock(&m_evaluationMutex);
+        if (canceled->load()) {
+            // discarded, the entry of the project is gone or belongs to a new import
+            return;
+        }
+        auto& evaluated = m_evaluatedProjectFiles[project];
+        if (evaluated.scheduled.contains(canonicalFile)) {
+            continue;
+        }
+        evaluated.scheduled.insert(canonicalFile);
+        evaluated.pending.insert(canonicalFile, QtConcurrent::run([this, project, file, canonicalFile, mkspecs, parentCache, canceled]() {
+            if (canceled->load()) {
+                // discarded before it started
+                return;
+            }
+
+            auto scope = new QMakeProjectFile(file);
+            scope->setProject(project);
+            scope->setMkSpecs(mkspecs);
+            if (QMakeCache* cache = findQMakeCache(project, Path(QFileInfo(file).dir().canonicalPath()))) {
+                cache->setMkSpecs(mkspecs);
+                cache->read();
+                scope->setQMakeCache(cache);
+            } else {
+                scope->setQMakeCache(parentCache);
+            }
+
+            if (!scope->read()) {
+                delete scope;
+                return;
+            }
+            evaluateSubProjects(project, scope, canceled);
+
+            QMutexLocker lock(&m_evaluationMutex);
+            if (canceled->load()) {
+                // discarded while it ran, nobody takes the result anymore
+                delete scope;
+                return;
+            }
+            m_evaluatedProjectFiles[project].results.insert(canonicalFile, scope);
+        }));
+    }
+}
+
+QMakeProjectFile* QMakeProjectManager::takeEvaluatedProjectFile(IProject* project, const QString& file)
+{
+    const QString canonicalFile = QFileInfo(file).canonicalFilePath();
+
+    QMutexLocker lock(&m_evaluationMutex);
+    auto it = m_evaluatedProjectFiles.find(project);
+    if (it == m_evaluatedProjectFiles.end()) {
+        return nullptr;
+    }
+    auto future = it->pending.take(canonicalFile);
+    lock.unlock();
+
+    if (future.isCanceled()) {
+        // not scheduled
+        return nullptr;
+    }
+    // if it did not start yet, this runs the evaluation in this thread
+    future.waitForFinished();
+
+    lock.relock();
+    it = m_evaluatedProjectFiles.find(project);
+    if (it == m_evaluatedProjectFiles.end()) {
+        return nullptr;
+    }
+    return it->results.take(canonicalFile);
+}
+
+void QMakeProjectManager::discardEvaluatedProjectFiles(IProject* project)
+{
+    QList<QFuture<void>> pending;
+    {
+        QMutexLocker lock(&m_evaluationMutex);
+        auto it = m_evaluatedProjectFiles.find(project);
+        if (it == m_evaluatedProjectFiles.end()) {
+            return;
+        }
+        // running evaluations neither schedule more nor store their results from now on
+        it->canceled->store(1);
+        qDeleteAll(it->results);
+        pending = it->pending.values();
+        m_evaluatedProjectFiles.erase(it);
+    }
+
+    // Evaluations which did not start yet return right away, so this only waits
+    // for the running ones, which use the project and this manager.
+    for (auto& future : pending) {
+        future.waitForFinished();
+    }
+}
+
 ContextMenuExtension QMakeProjectManager::contextMenuExtension(Context* context)
 {
     ContextMenuExtension ext;
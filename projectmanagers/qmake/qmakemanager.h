@@ -25,6 +25,12 @@
 #include <project/interfaces/ibuildsystemmanager.h>
 #include <project/abstractfilemanagerplugin.h>
 
+#include <QAtomicInt>
+#include <QFuture>
+#include <QMutex>
+#include <QSet>
+#include <QSharedPointer>
+
 class QMakeFolderItem;
 class IQMakeBuilder;
 class QMakeCache;
@@ -95,12 +101,35 @@ private:
     KDevelop::ProjectFolderItem* buildFolderItem( KDevelop::IProject* project, const KDevelop::Path& path,
                                                   KDevelop::ProjectBaseItem* parent );
     QMakeCache* findQMakeCache( KDevelop::IProject* project, const KDevelop::Path &path = {} ) const;
-    
+
+    /// Starts evaluating the SUBDIRS of @p pro in the background, recursively, unless @p canceled is set.
+    void evaluateSubProjects( KDevelop::IProject* project, QMakeProjectFile* pro,
+                              const QSharedPointer<QAtomicInt>& canceled );
+    /// @return the project file for @p file if it was evaluated in the background, nullptr otherwise.
+    ///         Ownership is transferred to the caller.
+    QMakeProjectFile* takeEvaluatedProjectFile( KDevelop::IProject* project, const QString& file );
+    /// Deletes all project files evaluated for @p project that were not taken.
+    void discardEvaluatedProjectFiles( KDevelop::IProject* project );
+
     IQMakeBuilder* m_builder;
     mutable QString m_qtIncludeDir;
     QAction* m_runQMake;
     QMakeFolderItem* m_actionItem;
 
+    struct EvaluatedProjectFiles
+    {
+        /// the canonical paths of all files that were ever scheduled, to evaluate files included in multiple SUBDIRS only once
+        QSet<QString> scheduled;
+        /// the evaluations not taken yet, keyed by canonical file path
+        QHash<QString, QFuture<void>> pending;
+        /// the project files the finished evaluations produced, keyed by canonical file path
+        QHash<QString, QMakeProjectFile*> results;
+        /// set when the project files are discarded, shared with the evaluations
+        QSharedPointer<QAtomicInt> canceled = QSharedPointer<QAtomicInt>(new QAtomicInt(0));
+    };
+    QMutex m_evaluationMutex;
+    QHash<KDevelop::IProject*, EvaluatedProjectFiles> m_evaluatedProjectFiles;
+
     static QMakeProjectManager* m_self;
 };
 
@@ -23,6 +23,7 @@
 #include <QtCore/QList>
 #include <QtCore/QStringList>
 #include <QtCore/QDir>
+#include <QtCore/QMutex>
 
 #include <kprocess.h>
 
@@ -38,6 +39,8 @@
 #define ifDebug(x)
 
 QHash<QString, QHash<QString, QString>> QMakeProjectFile::m_qmakeQueryCache;
+/// project files are evaluated in parallel by the project manager
+static QMutex s_qmakeQueryCacheMutex;
 
 const QStringList QMakeProjectFile::FileVariables = QStringList() << "IDLS"
                                                                   << "RESOURCES"
@@ -105,6 +108,7 @@ bool QMakeProjectFile::read()
     const QString qtInstallLibs = QStringLiteral("QT_INSTALL_LIBS");
 
     const QString executable = QMakeConfig::qmakeExecutable(project());
+    QMutexLocker lock(&s_qmakeQueryCacheMutex);
     if (!m_qmakeQueryCache.contains(executable)) {
         const auto queryResult = QMakeConfig::queryQMake(executable, {qtInstallHeaders, qtVersion, qtInstallLibs});
         if (queryResult.isEmpty()) {
@@ -114,6 +118,7 @@ bool QMakeProjectFile::read()
     }
 
     const auto cachedQueryResult = m_qmakeQueryCache.value(executable);
+    lock.unlock();
     m_qtIncludeDir = cachedQueryResult.value(qtInstallHeaders);
     m_qtVersion = cachedQueryResult.value(qtVersion);
     m_qtLibDir = cachedQueryResult.value(qtInstallLibs);
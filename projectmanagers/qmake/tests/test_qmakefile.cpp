@@ -501,6 +501,48 @@ void TestQMakeFile::testInclude()
     QVERIFY(file.includeDirectories().contains(tempDir.path()));
 }
 
+void TestQMakeFile::testSharedAst()
+{
+    const QByteArray contents = "TEMPLATE = app\n"
+                                "TARGET = sharedAst\n"
+                                "SOURCES += $$PWD/main.cpp\n";
+
+    QTemporaryDir firstDir;
+    QVERIFY(firstDir.isValid());
+    QFile firstFile(firstDir.path() + "/first.pro");
+    QVERIFY(firstFile.open(QIODevice::WriteOnly));
+    firstFile.write(contents);
+    firstFile.close();
+
+    QTemporaryDir secondDir;
+    QVERIFY(secondDir.isValid());
+    QFile secondFile(secondDir.path() + "/second.pro");
+    QVERIFY(secondFile.open(QIODevice::WriteOnly));
+    secondFile.write(contents);
+    secondFile.close();
+
+    QMakeProjectFile first(firstFile.fileName());
+    setDefaultMKSpec(first);
+    QVERIFY(first.read());
+
+    QMakeProjectFile second(secondFile.fileName());
+    setDefaultMKSpec(second);
+    QVERIFY(second.read());
+
+    // same content, parsed once, but evaluated in the context of each file
+    QCOMPARE(first.ast(), second.ast());
+    QCOMPARE(first.variableValues("SOURCES"), QStringList() << firstDir.path() + "/main.cpp");
+    QCOMPARE(second.variableValues("SOURCES"), QStringList() << secondDir.path() + "/main.cpp");
+
+    // modified files are parsed again
+    QVERIFY(secondFile.open(QIODevice::WriteOnly | QIODevice::Append));
+    secondFile.write("TARGET = changed\n");
+    secondFile.close();
+    QVERIFY(second.read());
+    QVERIFY(first.ast() != second.ast());
+    QCOMPARE(second.variableValues("TARGET"), QStringList() << "changed");
+}
+
 void TestQMakeFile::globbing_data()
 {
     QTest::addColumn<QStringList>("files");
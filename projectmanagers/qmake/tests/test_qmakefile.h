@@ -46,6 +46,7 @@ private slots:
     void qtIncludeDirs();
 
     void testInclude();
+    void testSharedAst();
 
     void globbing_data();
     void globbing();